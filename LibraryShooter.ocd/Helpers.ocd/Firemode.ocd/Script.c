@@ -1,11 +1,13 @@
 ﻿/**
 	A dummy definition, used to provide various getters and setters for fire modes.
 	Keep in mind that for fire modes to be writable, they must be created using {@link Library_Firearm#AddFiremode}.
+	Every setter increases the version of the fire mode, so that weapons know when to recompile it (see {@link Library_Firearm#GetCompiledFiremode}).
 
 	@author Clonkonaut
 	@version 0.3.0
 */
 
+static g_firemode_version; // int - the last version that was given to a fire mode
 
 /*-- Getters --*/
 
@@ -90,6 +92,15 @@ public func GetRecoveryDelay()
 	return this.delay_recover;
 }
 
+/**
+ Get the fire rate of this fire mode.
+ @return An integer, shots per minute, or {@c nil} if the recovery delay is used.
+*/
+public func GetFireRate()
+{
+	return this.rate;
+}
+
 /**
  Get the cooldown delay of this fire mode.
  @return An integer.
@@ -108,6 +119,33 @@ public func GetReloadDelay()
 	return this.delay_reload;
 }
 
+/**
+ Get the heat per shot of this fire mode.
+ @return An integer.
+*/
+public func GetHeatPerShot()
+{
+	return this.heat_per_shot;
+}
+
+/**
+ Get the heat decay of this fire mode.
+ @return An integer.
+*/
+public func GetHeatDecay()
+{
+	return this.heat_decay;
+}
+
+/**
+ Get the heat limit of this fire mode.
+ @return An integer.
+*/
+public func GetHeatLimit()
+{
+	return this.heat_limit;
+}
+
 /**
  Get the damage of this fire mode.
  @return An integer.
@@ -135,6 +173,15 @@ public func GetProjectileID()
 	return this.projectile_id;
 }
 
+/**
+ Get the beam ID of this fire mode.
+ @return An ID.
+*/
+public func GetBeamID()
+{
+	return this.beam_id;
+}
+
 /**
  Get the projectile speed of this fire mode.
  @return An integer.
@@ -189,6 +236,24 @@ public func GetSpread()
 	return this.spread;
 }
 
+/**
+ Get the spread decay of this fire mode.
+ @return An integer.
+*/
+public func GetSpreadDecay()
+{
+	return this.spread_decay;
+}
+
+/**
+ Get the spread limit of this fire mode.
+ @return An integer.
+*/
+public func GetSpreadLimit()
+{
+	return this.spread_limit;
+}
+
 /**
  Get the amount of projectiles firing in a burst of this fire mode.
  @return An integer.
@@ -207,6 +272,15 @@ public func GetAutoReload()
 	return this.auto_reload;
 }
 
+/**
+ Get the reload step of this fire mode.
+ @return An integer.
+*/
+public func GetReloadStep()
+{
+	return this.reload_step;
+}
+
 /**
  Get the shooting animation name of this fire mode.
  @return A string.
@@ -252,6 +326,7 @@ public func GetBackwardWalkingSpeed()
 	- WEAPON_FM_Single: single shot style, only shot per click is fired (default).@br
 	- WEAPON_FM_Burst: burst style, firing a set number of shot in short succession.@br
 	- WEAPON_FM_Auto: auto style, firing as long as the use button is pressed.@br
+	- WEAPON_FM_Beam: beam style, a continuous beam that deals damage in intervals as long as the use button is pressed.@br
 	
  @return proplist Returns the fire mode,
          so that further function calls can be issued.
@@ -259,7 +334,7 @@ public func GetBackwardWalkingSpeed()
 public func SetMode(int value)
 {
 	this.mode = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -274,7 +349,7 @@ public func SetMode(int value)
 public func SetName(string value)
 {
 	this.name = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -289,7 +364,7 @@ public func SetName(string value)
 public func SetIcon(id value)
 {
 	this.icon = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -305,7 +380,7 @@ public func SetIcon(id value)
 public func SetCondition(value)
 {
 	this.condition = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -318,7 +393,7 @@ public func SetCondition(value)
 public func SetAmmoID(id value)
 {
 	this.ammo_id = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -331,7 +406,7 @@ public func SetAmmoID(id value)
 public func SetAmmoUsage(int value)
 {
 	this.ammo_usage = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -344,7 +419,7 @@ public func SetAmmoUsage(int value)
 public func SetAmmoRate(int value)
 {
 	this.ammo_rate = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -359,7 +434,7 @@ public func SetAmmoRate(int value)
 public func SetChargeDelay(int value)
 {
 	this.delay_charge = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -373,7 +448,22 @@ public func SetChargeDelay(int value)
 public func SetRecoveryDelay(int value)
 {
 	this.delay_recover = value;
-	return this;
+	return IncreaseVersion();
+}
+
+/**
+ Set the fire rate of this fire mode.
+ 
+ @par value Shots per minute. If set, this replaces the recovery
+            delay, with a precision of fractions of a frame.
+            If 0 or nil, the recovery delay is used.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetFireRate(int value)
+{
+	this.rate = value;
+	return IncreaseVersion();
 }
 
 /**
@@ -389,7 +479,7 @@ public func SetRecoveryDelay(int value)
 public func SetCooldownDelay(int value)
 {
 	this.delay_cooldown = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -402,7 +492,48 @@ public func SetCooldownDelay(int value)
 public func SetReloadDelay(int value)
 {
 	this.delay_reload = value;
-	return this;
+	return IncreaseVersion();
+}
+
+/**
+ Set the heat per shot of this fire mode.
+ 
+ @par value The weapon heats up by this much with every shot.
+            If 0 or nil, the weapon does not heat up.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetHeatPerShot(int value)
+{
+	this.heat_per_shot = value;
+	return IncreaseVersion();
+}
+
+/**
+ Set the heat decay of this fire mode.
+ 
+ @par value The heat of the weapon decreases by this much per second.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetHeatDecay(int value)
+{
+	this.heat_decay = value;
+	return IncreaseVersion();
+}
+
+/**
+ Set the heat limit of this fire mode.
+ 
+ @par value The weapon overheats if its heat reaches this value,
+            and cannot fire until it has cooled down completely.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetHeatLimit(int value)
+{
+	this.heat_limit = value;
+	return IncreaseVersion();
 }
 
 /**
@@ -415,7 +546,7 @@ public func SetReloadDelay(int value)
 public func SetDamage(int value) // yes, this shadows an engine function!
 {
 	this.damage = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -430,7 +561,7 @@ public func SetDamage(int value) // yes, this shadows an engine function!
 public func SetDamageType(int value)
 {
 	this.damage_type = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -444,7 +575,21 @@ public func SetDamageType(int value)
 public func SetProjectileID(id value)
 {
 	this.projectile_id = value;
-	return this;
+	return IncreaseVersion();
+}
+
+/**
+ Set the beam ID of this fire mode.
+ 
+ @par value A definition of the beam that is displayed in beam mode style.
+            A single beam is created when firing starts and removed when firing stops.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetBeamID(id value)
+{
+	this.beam_id = value;
+	return IncreaseVersion();
 }
 
 /**
@@ -457,7 +602,7 @@ public func SetProjectileID(id value)
 public func SetProjectileSpeed(int value)
 {
 	this.projectile_speed = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -472,7 +617,7 @@ public func SetProjectileSpeed(int value)
 public func SetProjectileSpread(proplist value)
 {
 	this.projectile_spread = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -485,7 +630,7 @@ public func SetProjectileSpread(proplist value)
 public func SetProjectileRange(int value)
 {
 	this.projectile_range = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -498,7 +643,7 @@ public func SetProjectileRange(int value)
 public func SetProjectileDistance(int value)
 {
 	this.projectile_distance = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -513,7 +658,7 @@ public func SetProjectileDistance(int value)
 public func SetYOffset(int value)
 {
 	this.projectile_offset_y = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -528,7 +673,36 @@ public func SetYOffset(int value)
 public func SetSpread(proplist value)
 {
 	this.spread = value;
-	return this;
+	return IncreaseVersion();
+}
+
+/**
+ Set the spread decay of this fire mode.
+ 
+ @par value The spread from prolonged firing decreases by this much
+            per second, in the precision of the spread.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetSpreadDecay(int value)
+{
+	this.spread_decay = value;
+	return IncreaseVersion();
+}
+
+/**
+ Set the spread limit of this fire mode.
+ 
+ @par value If set, the spread grows by its angle with every shot,
+            up to this value, in the precision of the spread.
+            If nil, the spread is always applied fully.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetSpreadLimit(int value)
+{
+	this.spread_limit = value;
+	return IncreaseVersion();
 }
 
 /**
@@ -541,7 +715,7 @@ public func SetSpread(proplist value)
 public func SetBurstAmount(int value)
 {
 	this.burst = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -555,7 +729,23 @@ public func SetBurstAmount(int value)
 public func SetAutoReload(bool value)
 {
 	this.auto_reload = value;
-	return this;
+	return IncreaseVersion();
+}
+
+/**
+ Set the reload step of this fire mode.
+ 
+ @par value The amount of rounds that are loaded at a time,
+            each of them taking the reload delay. Pulling the
+            trigger interrupts reloading after a step.
+            If 0 or nil, everything is loaded at once.
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func SetReloadStep(int value)
+{
+	this.reload_step = value;
+	return IncreaseVersion();
 }
 
 /**
@@ -570,7 +760,7 @@ public func SetAutoReload(bool value)
 public func SetShootingAnimation(string value)
 {
 	this.anim_shoot_name = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -585,7 +775,7 @@ public func SetShootingAnimation(string value)
 public func SetReloadAnimation(string value)
 {
 	this.anim_load_name = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -599,7 +789,7 @@ public func SetReloadAnimation(string value)
 public func SetForwardWalkingSpeed(int value)
 {
 	this.walk_speed_front = value;
-	return this;
+	return IncreaseVersion();
 }
 
 /**
@@ -613,5 +803,35 @@ public func SetForwardWalkingSpeed(int value)
 public func SetBackwardWalkingSpeed(int value)
 {
 	this.walk_speed_back = value;
+	return IncreaseVersion();
+}
+
+/*-- Versioning --*/
+
+/**
+ Get the version of this fire mode.
+ @return An integer that increases each time a setter is called
+         on this fire mode, or on a fire mode that it inherits from.
+*/
+public func GetVersion()
+{
+	var version = 0;
+	for (var mode = this; mode != nil && mode != Library_Firearm_Firemode; mode = GetPrototype(mode))
+	{
+		version = Max(version, mode.version);
+	}
+	return version;
+}
+
+/**
+ Mark this fire mode as changed.
+ 
+ @return proplist Returns the fire mode,
+         so that further function calls can be issued.
+*/
+public func IncreaseVersion()
+{
+	g_firemode_version += 1;
+	this.version = g_firemode_version;
 	return this;
-}
\ No newline at end of file
+}
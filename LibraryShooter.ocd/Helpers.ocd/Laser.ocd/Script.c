@@ -1,5 +1,3 @@
-
-
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // definitions
@@ -11,6 +9,12 @@ local angle;	// int - the rotation of the laser, in degrees
 local lifetime;	// int - the time until the laser is removed, in frames
 local timer;	// int - the time that has already passed, in frames
 
+local beam_end;				// array - cached end point of the beam, relative to the laser
+local beam_length;			// int - cached length of the beam, after checking the landscape, in pixels
+local beam_blocker;			// array - position just behind the end of a blocked beam, relative to the laser
+local beam_dirty;			// bool - if true, the beam has to be recomputed on the next update
+local stop_at_landscape;	// bool - if true, the beam ends at solid landscape
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // global functions
@@ -19,6 +23,72 @@ local timer;	// int - the time that has already passed, in frames
 //
 // finished functions
 
+/**
+ Interval in frames for checking whether the landscape along the beam changed.@br
+ The end point of a blocked beam is checked every frame, because this is cheap.
+ A full raycast along the beam is done only in this interval.
+ @return int The interval, in frames. Overload this for a custom interval.
+ @version 0.3.0
+ */
+public func LaserLandscapeCheckInterval()
+{
+	return 10;
+}
+
+/**
+ Configures the beam to end at solid landscape.
+ @par value If {@c true}, the beam is shortened to the first solid pixel along its path.
+ @return object Returns the laser, so that further function calls can be issued.
+ @version 0.3.0
+ */
+public func StopAtLandscape(bool value)
+{
+	stop_at_landscape = value;
+	Invalidate();
+	return this;
+}
+
+/**
+ Marks the beam as outdated. It will be recomputed on the next update,
+ all other updates of the beam are skipped.
+ @return object Returns the laser, so that further function calls can be issued.
+ @version 0.3.0
+ */
+public func Invalidate()
+{
+	beam_dirty = true;
+	WakeTracking();
+	return this;
+}
+
+/**
+ Recomputes the beam end point and the draw transformation, but only
+ if any input changed since the last update.
+ @return object Returns the laser, so that further function calls can be issued.
+ @version 0.3.0
+ */
+public func Update()
+{
+	if (beam_dirty && IsActive())
+	{
+		beam_dirty = false;
+		UpdateBeam();
+		DrawTransform();
+	}
+	return this;
+}
+
+/**
+ Checks whether the laser is currently displayed.
+ @return bool {@c true} if the laser was activated.
+ @version 0.3.0
+ */
+public func IsActive()
+{
+	var name = GetAction();
+	return name == "Laser" || name == "LaserEnd";
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // temporary stuff
@@ -27,6 +97,7 @@ local timer;	// int - the time that has already passed, in frames
 local pAttach;
 local dx;
 local dy;
+local is_attached; // bool - the laser was attached to an object
 
 protected func Initialize()
 {
@@ -37,37 +108,65 @@ protected func Initialize()
 	width = 3;
 	length = 300;
 	timer = 0;
+	beam_dirty = true;
 }
 
 /* Interface (public functions) */
 
 public func SetPosi(int iPos)
 {
-	phase = iPos;
+	if (phase != iPos)
+	{
+		phase = iPos;
+		Invalidate();
+	}
 	return this;
 }
 
 public func SetRotation(int rotation)
 {
-	angle = rotation - 180;
+	if (angle != rotation - 180)
+	{
+		angle = rotation - 180;
+		Invalidate();
+	}
 	return this;
 }
 
 public func SetWidth(int pixels)
 {
 	width = 1000 * pixels / this.ActMap["Laser"].Wdt;
+	Invalidate();
 	return this;
 }
 
 public func SetLifetime(int frames)
 {
 	lifetime = frames;
+	WakeTracking();
 	return this;
 }
 
-public func Attach(object pAtt)
+/**
+ Attaches the laser to an object, with an offset. The laser follows the object
+ for as long as it is attached. The position is compared every frame, but the beam
+ is recomputed only if the object moved.
+ @par pAtt The object.
+ @par x The x offset, relative to the object.
+ @par y The y offset, relative to the object.
+ @return object Returns the laser, so that further function calls can be issued.
+ */
+public func Attach(object pAtt, int x, int y)
 {
-	pAttach = pAtt;
+	var moved = pAtt && (pAtt->GetX() + x != GetX() || pAtt->GetY() + y != GetY());
+	if (pAttach != pAtt || dx != x || dy != y || moved)
+	{
+		pAttach = pAtt;
+		dx = x;
+		dy = y;
+		is_attached = pAtt != nil;
+		Invalidate();
+	}
 	return this;
 }
 
@@ -76,7 +175,7 @@ public func Color(int rgba)
 	var a = GetRGBaValue(GetClrModulation(), RGBA_ALPHA);
 	rgba = SetRGBaValue(rgba, a, RGBA_ALPHA);
 	SetClrModulation(rgba);
-	
+
 	return this;
 }
 
@@ -89,7 +188,11 @@ public func Line(int x_start, int y_start, int x_end, int y_end)
 
 public func SetRange(int pixels)
 {
-	length = pixels;
+	if (length != pixels)
+	{
+		length = pixels;
+		Invalidate();
+	}
 	return this;
 }
 
@@ -104,63 +207,161 @@ public func GetLaserWidth()
 }
 
 public func GetLaserLength()
-{ 
-	var name = GetAction();
-	if (name == "Idle") name = "Laser";
-	
-	return length * this.ActMap[name].Hgt / 1000;
+{
+	if (beam_dirty) UpdateBeam();
+
+	return beam_length;
 }
 
 public func LaserEnd(int x, int y)
 {
-	x = +Sin(GetRotation(), GetLaserLength());
-	y = -Cos(GetRotation(), GetLaserLength());
-	
-	return [x, y];
+	if (beam_dirty) UpdateBeam();
+
+	return [beam_end[0], beam_end[1]];
 }
 
-private func Activate()
+public func Activate()
 {
-	if(GetAction() != "Laser")
+	if (!IsActive())
 	{
 		SetAction("Laser");
 	}
-	
-	DrawTransform();
+
+	beam_dirty = true;
+	Update();
+	WakeTracking();
 }
 
-private func Update()
+/**
+ The cached raycast: determines the end point of the beam. This is the only place
+ where the landscape is checked along the whole beam.
+ */
+private func UpdateBeam()
 {
-	DrawTransform();
+	var rotation = GetRotation();
+	var end_x = +Sin(rotation, length);
+	var end_y = -Cos(rotation, length);
+
+	beam_length = length;
+	beam_blocker = nil;
+
+	if (stop_at_landscape)
+	{
+		var coords = PathFree2(GetX(), GetY(), GetX() + end_x, GetY() + end_y);
+		if (coords)
+		{
+			end_x = coords[0] - GetX();
+			end_y = coords[1] - GetY();
+			beam_length = Distance(0, 0, end_x, end_y);
+			beam_blocker = [end_x + Sin(rotation, 2), end_y - Cos(rotation, 2)];
+		}
+	}
+
+	beam_end = [end_x, end_y];
 }
 
-protected func Laser()
+/**
+ Checks the inputs of the beam: the attached object, the landscape, and the lifetime.
+ An attached laser, a laser that stops at the landscape, and a laser with a lifetime
+ are checked every frame. The engine does not report when the attached object moves
+ or when the landscape changes, so these are polled; the beam itself is recomputed
+ only if an input changed.
+ @return bool {@c true} if the inputs have to be checked again in the next frame.
+ */
+func TrackInputs(int time)
 {
-	DrawTransform();
+	var keep_tracking = false;
 
-	// attach to obj
-	// if(pAttach) SetPosition(dx + pAttach->GetX(), dy + pAttach->GetY());
+	// follow the attached object; remove the laser if the object is gone
+	if (is_attached)
+	{
+		if (!pAttach)
+		{
+			RemoveObject();
+			return false;
+		}
+
+		// the object may start moving again at any time
+		keep_tracking = true;
+
+		var x = pAttach->GetX() + dx;
+		var y = pAttach->GetY() + dy;
+		if (x != GetX() || y != GetY())
+		{
+			SetPosition(x, y);
+			beam_dirty = true;
+		}
+	}
+
+	if (!IsActive()) return keep_tracking;
 
-	// animation & effect
-	SetPhase(Random(4));
+	// the landscape along the beam may change; the cheap check of the blocker runs every frame,
+	// the full raycast only in the landscape check interval
+	if (stop_at_landscape)
+	{
+		keep_tracking = true;
+
+		if (!beam_dirty)
+		{
+			if (beam_blocker && !GBackSolid(beam_blocker[0], beam_blocker[1]))
+			{
+				beam_dirty = true;
+			}
+			else if (time % Max(1, LaserLandscapeCheckInterval()) == 0)
+			{
+				beam_dirty = true;
+			}
+		}
+	}
+
+	Update();
 
 	// fade out (only if lifetime != 0)
-	if(!lifetime) return;
+	if (lifetime)
+	{
+		keep_tracking = true;
+
+		var a = 200 * (lifetime - timer) / lifetime;
+		var rgba = SetRGBaValue(GetClrModulation(), a, RGBA_ALPHA);
+		SetClrModulation(rgba);
+
+		++timer;
+		if (timer >= lifetime)
+		{
+			RemoveObject();
+			return false;
+		}
+	}
 
-	var a = 200 * (lifetime - timer) / lifetime;
-	var rgba = SetRGBaValue(GetClrModulation(), a, RGBA_ALPHA);
-	SetClrModulation(rgba);
+	return keep_tracking;
+}
 
-	++timer;
-	if(timer >= lifetime) RemoveObject();
+/**
+ Makes sure that the tracking effect checks the inputs in the next frame.
+ */
+private func WakeTracking()
+{
+	var effect = GetEffect("IntLaserTracking", this) ?? CreateEffect(IntLaserTracking, 1, 1);
+	effect.Interval = 1;
 }
 
+local IntLaserTracking = new Effect {
+	Timer = func(int time)
+	{
+		if (!this.Target->TrackInputs(time))
+		{
+			// Nothing changes by itself, so sleep until the laser is invalidated again
+			this.Interval = 0;
+		}
+		return FX_OK;
+	}
+};
+
 private func DrawTransform()
 {
 	// draw line
 
-	var current_length = BoundBy(length - phase, 0, length);
-	current_length = 1000 * length / this.ActMap[GetAction()].Hgt;
+	var current_length = 1000 * beam_length / this.ActMap[GetAction()].Hgt;
 
 	var fsin = -Sin(angle, 1000);
 	var fcos = +Cos(angle, 1000);
@@ -191,6 +392,8 @@ local BorderBound = 7;
 //
 // actions
 
+// The animation phases are advanced by the engine, the actions do not call
+// into the script: the beam is only updated if its inputs change.
 local ActMap = {
 Laser = {
 	Prototype = Action,
@@ -203,7 +406,6 @@ Laser = {
 	Wdt = 32,
 	Hgt = 96,
 	NextAction = "Laser",
-	PhaseCall = "Laser",
 },
 
 LaserEnd = {
@@ -217,6 +419,5 @@ LaserEnd = {
 	Wdt = 32,
 	Hgt = 128,
 	NextAction = "LaserEnd",
-	PhaseCall = "Laser",
 },
 };
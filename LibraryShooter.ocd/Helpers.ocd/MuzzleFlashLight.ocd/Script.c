@@ -0,0 +1,78 @@
+/**
+	A light for muzzle flashes.
+
+	A firearm keeps a single instance of this light and re-triggers it
+	on every shot, instead of creating a new light source per shot.
+	The intensity of the flash follows {@link MuzzleFlashLight#GetFlashKeyFrames}.
+
+	@author Marky
+	@version 0.3.0
+*/
+
+local flash_range;	// int - the light range at full intensity, in pixels
+local flash_frame;	// int - the current key frame
+
+/**
+ Triggers the flash. If the light is still flashing, the flash starts over.
+ @par x The x position of the light, in global coordinates.
+ @par y The y position of the light, in global coordinates.
+ @par range The light range at full intensity, in pixels.
+ @par color The light color. Default is white.
+ @return object Returns the light, so that further function calls can be issued.
+ */
+public func Flash(int x, int y, int range, int color)
+{
+	SetPosition(x, y);
+	SetLightColor(color ?? RGB(255, 255, 255));
+
+	flash_range = range;
+	flash_frame = 0;
+	UpdateFlash();
+
+	var effect = GetEffect("IntFlash", this) ?? CreateEffect(IntFlash, 1, 1);
+	effect.Interval = 1;
+	return this;
+}
+
+/**
+ The intensity of the flash, per frame.
+ @return array Intensity values in per mille, one value per frame.
+         The light is switched off after the last value.
+ */
+public func GetFlashKeyFrames()
+{
+	return [1000, 500];
+}
+
+/**
+ Applies the intensity of the current key frame.
+ @return bool {@c true} if the light is still on.
+ */
+func UpdateFlash()
+{
+	var key_frames = GetFlashKeyFrames();
+	if (flash_frame < GetLength(key_frames))
+	{
+		var range = flash_range * key_frames[flash_frame] / 1000;
+		SetLightRange(range, range);
+		return true;
+	}
+	else
+	{
+		SetLightRange(0, 0);
+		return false;
+	}
+}
+
+local IntFlash = new Effect {
+	Timer = func()
+	{
+		this.Target.flash_frame += 1;
+		if (!this.Target->UpdateFlash())
+		{
+			// Sleep until the next shot
+			this.Interval = 0;
+		}
+		return FX_OK;
+	}
+};
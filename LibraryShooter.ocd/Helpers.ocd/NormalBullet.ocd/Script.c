@@ -52,7 +52,7 @@ protected func Hit()
 	
 	if(self)
 	{
-		Sound("BulletHitGround?");
+		ThrottledSound("BulletHitGround?");
 		CreateImpactEffect(Max(5, damage*2/3));
 	  	
 	  	RemoveObject();
@@ -122,10 +122,7 @@ public func Fire(object shooter, int angle, int dev, int dist, int dmg, id weapo
 	
 	if(!shooter.silencer)
 	{
-		var t = CreateObject(Bullet_TrailEffect, 0, 0, NO_OWNER);
-		t->Point({x = x_p, y = y_p}, {x = GetX(), y = GetY()});
-		t->FadeOut();
-		t->SetObjectBlitMode(GFX_BLIT_Additive);
+		Bullet_TrailEffect->Draw({x = x_p, y = y_p}, {x = GetX(), y = GetY()});
 	}
 	
 	var self = this;
@@ -180,9 +177,9 @@ public func HitObject(object obj, bool remove, proplist effect)
 public func OnHitObject(object obj)
 {
 	if(obj->GetAlive())
-		Sound("ProjectileHitLiving?");
+		ThrottledSound("ProjectileHitLiving?");
 	else
-		Sound("BulletHitGround?");
+		ThrottledSound("BulletHitGround?");
 }
 
 
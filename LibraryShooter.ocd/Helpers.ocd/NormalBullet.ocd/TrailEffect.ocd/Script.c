@@ -1,12 +1,17 @@
 /**
 	TrailEffect
 	Visual.
+
+	Lines should be drawn with Bullet_TrailEffect->Draw(from, to): the lines come
+	from a ring buffer of limited size and fade out with a single shared timer.
+	If the buffer is full, the oldest line is recycled.
 */
 
 local Name = "$Name$";
 local Description = "$Description$";
 
 local last_from, last_to;
+local fade_time; // int - frames since the line started fading, nil if the line does not fade
 
 func Initialize()
 {
@@ -34,25 +39,116 @@ func Point(from, to)
 	SetPosition(midpoint_x, midpoint_y);
 }
 
+/**
+ Fades out this line with its own timer, and removes it afterwards.
+ Prefer {@link Bullet_TrailEffect#Draw} if many lines are drawn.
+ */
 func FadeOut()
 {
+	fade_time = 0;
 	AddEffect("QuickFade", this, 1, 1, this);
 }
 
 func FxQuickFadeTimer(target, proplist effect, time)
 {
-	
+	if (!FadeStep())
+	{
+		RemoveObject();
+		return -1;
+	}
+}
+
+/**
+ Advances the fading by one frame: the line shrinks towards its end point and becomes more transparent.
+ @return bool {@c true} if the line is still fading, {@c false} if it is invisible now.
+ */
+func FadeStep()
+{
+	if (fade_time == nil) return false;
+
+	fade_time += 1;
+
 	var x = (last_from.x + last_to.x) / 2;
 	var y = (last_from.y + last_to.y) / 2;
-	
+
 	Point({x = x, y = y}, last_to);
-	
-	var fade = time * 10;
+
+	var fade = fade_time * 10;
 	if(fade > 90 || ((x == last_to.x) && (y == last_to.y)))
 	{
-		RemoveObject();
-		return -1;
+		fade_time = nil;
+		this.Visibility = VIS_None;
+		return false;
 	}
-	
+
 	SetClrModulation(RGBa(255, 255, 255, 100 - fade));
-}
\ No newline at end of file
+	return true;
+}
+
+/*-- Pool --*/
+
+/**
+ The maximum amount of pooled lines that exist at the same time.
+ @return int The pool capacity. Overload this for a custom capacity.
+ */
+public func GetPoolCapacity()
+{
+	return 40;
+}
+
+/**
+ Draws a line that fades out. This should be called from the definition,
+ {@c Bullet_TrailEffect->Draw(from, to)}.@br
+ The line is taken from a ring buffer. If all lines in the buffer are in use,
+ the oldest line is recycled, so that the amount of lines is bounded even
+ under sustained fire.
+ @par from A proplist with the properties x and y, the start of the line in global coordinates.
+ @par to A proplist with the properties x and y, the end of the line in global coordinates.
+ @return object The line.
+ */
+public func Draw(proplist from, proplist to)
+{
+	var pool = GetEffect("IntTrailEffectPool") ?? AddEffect("IntTrailEffectPool", nil, 1, 1, nil, Bullet_TrailEffect);
+
+	var line = pool.lines[pool.next];
+	if (!line)
+	{
+		line = CreateObject(Bullet_TrailEffect, 0, 0, NO_OWNER);
+		line->SetObjectBlitMode(GFX_BLIT_Additive);
+		pool.lines[pool.next] = line;
+	}
+	pool.next = (pool.next + 1) % Max(1, Bullet_TrailEffect->GetPoolCapacity());
+
+	line.Visibility = VIS_All;
+	line->SetClrModulation(RGBa(255, 255, 255, 100));
+	line->Point(from, to);
+	line.fade_time = 0;
+
+	// Wake up the shared fade timer
+	pool.Interval = 1;
+	return line;
+}
+
+func FxIntTrailEffectPoolStart(object target, proplist effect, int temporary)
+{
+	if (temporary) return;
+
+	effect.lines = [];
+	effect.next = 0;
+}
+
+func FxIntTrailEffectPoolTimer(object target, proplist effect, int time)
+{
+	var fading = false;
+	for (var line in effect.lines)
+	{
+		if (line && line->FadeStep())
+		{
+			fading = true;
+		}
+	}
+
+	// Sleep until the next line is drawn
+	if (!fading) effect.Interval = 0;
+	return FX_OK;
+}
@@ -15,9 +15,11 @@ static const AMMO_Source_Items = 2; // ammo is saved from collected items, such
 static const AMMO_Source_Container = 3;	// ammo is saved in the carrier of the weapon (as in arcade games)
 static const AMMO_Source_Infinite = 4;	// ammo is unlimited - yay for cheats
 
+static g_ammo_slot_types; // array - the ammunition types, indexed by their slot
+
 /* --- Properties --- */
 
-local library_ammo_manager;
+local library_ammo_manager; // proplist - ammo: array with the amount of ammunition, indexed by slot; items: array with the amount of ammunition in collected items, indexed by slot; items_changed: bool, a stack in the object changed its count
 
 /* --- Engine callbacks --- */
 
@@ -27,7 +29,65 @@ local library_ammo_manager;
  */
 public func Construction()
 {
-	library_ammo_manager = library_ammo_manager ?? {};
+	library_ammo_manager = library_ammo_manager ?? { ammo = [], items = [] };
+	return _inherited(...);
+}
+
+/**
+ Counts the ammunition in items that enter the object.
+ Objects that include this library must call {@link Global#inherited}
+ for this function.
+ */
+public func Collection2(object item)
+{
+	var ammo = item->GetID();
+	if (GetAmmoSource(ammo) == AMMO_Source_Items)
+	{
+		DoAmmoItemCount(ammo, GetAmmoItemAmount(item));
+	}
+	return _inherited(item, ...);
+}
+
+/**
+ Counts the ammunition in items that leave the object.
+ Objects that include this library must call {@link Global#inherited}
+ for this function.
+ */
+public func Ejection(object item)
+{
+	var ammo = item->GetID();
+	if (GetAmmoSource(ammo) == AMMO_Source_Items)
+	{
+		DoAmmoItemCount(ammo, -GetAmmoItemAmount(item));
+	}
+	return _inherited(item, ...);
+}
+
+/**
+ Counts the ammunition in items that are removed while in the object.
+ Objects that include this library must call {@link Global#inherited}
+ for this function.
+ */
+public func ContentsDestruction(object item)
+{
+	var ammo = item->GetID();
+	if (GetAmmoSource(ammo) == AMMO_Source_Items)
+	{
+		DoAmmoItemCount(ammo, -GetAmmoItemAmount(item));
+	}
+	return _inherited(item, ...);
+}
+
+/**
+ Called by stackable items in the object when their stack count changes,
+ for example when another stack is merged into them. The ammunition in items
+ is counted again the next time that it is needed.
+ Objects that include this library must call {@link Global#inherited}
+ for this function.
+ */
+public func OnInventoryChange()
+{
+	library_ammo_manager.items_changed = true;
 	return _inherited(...);
 }
 
@@ -39,7 +99,7 @@ public func Construction()
  {@table
    {@tr {@th Constant} {@th Value} {@th Description}}
    {@tr {@td AMMO_Source_Local} {@td 1} {@td The ammunition is saved as a local variable in this object.}}
-   {@tr {@td AMMO_Source_Items} {@td 2} {@td The ammunition is requested from a certain object.}}
+   {@tr {@td AMMO_Source_Items} {@td 2} {@td The ammunition is counted from collected items of that type, such as arrow packs.}}
    {@tr {@td AMMO_Source_Container} {@td 3} {@td The ammunition is requested from a certain object.}}
    {@tr {@td AMMO_Source_Infinite} {@td 4} {@td The object has unlimited ammunition.}}
  }
@@ -53,6 +113,27 @@ public func GetAmmoSource(id ammo)
 	return AMMO_Source_Infinite;
 }
 
+/**
+ Gets the slot of an ammunition type.@br
+ Each ammunition type gets a dense integer index the first time that it is used,
+ so that the amount of ammunition can be stored in an array. The slots are the same in all objects.
+ @par ammo The type of the ammunition.
+ @return int The slot, starting at 0.
+ @version 0.3.0
+ */
+public func GetAmmoSlot(id ammo)
+{
+	g_ammo_slot_types = g_ammo_slot_types ?? [];
+
+	var slot = GetIndexOf(g_ammo_slot_types, ammo);
+	if (slot < 0)
+	{
+		slot = GetLength(g_ammo_slot_types);
+		PushBack(g_ammo_slot_types, ammo);
+	}
+	return slot;
+}
+
 /**
  Gets the current amount of ammunition of a certain type.
  @par ammo The type of the ammunition.
@@ -73,11 +154,15 @@ public func GetAmmo(id ammo)
 
 	if (ammo_source == AMMO_Source_Local)
 	{
-		return Max(0, library_ammo_manager[Format("%i", ammo)]);
+		return Max(0, library_ammo_manager.ammo[GetAmmoSlot(ammo)]);
 	}
 	else if (ammo_source == AMMO_Source_Items)
 	{
-		FatalError("This is not implemented yet.");
+		if (library_ammo_manager.items_changed)
+		{
+			UpdateChangedAmmoItems();
+		}
+		return library_ammo_manager.items[GetAmmoSlot(ammo)] ?? 0;
 	}
 	else if (ammo_source == AMMO_Source_Container)
 	{
@@ -129,6 +214,148 @@ public func DoAmmo(id ammo, int amount)
 	}
 }
 
+/**
+ Takes ammunition from the object, if there is enough.@br
+ This checks and changes the amount of ammunition in a single call, so it should be preferred over
+ {@link Library_AmmoManager#GetAmmo} followed by {@link Library_AmmoManager#DoAmmo}, especially
+ if the ammunition is held by another object.
+ @par ammo The type of the ammunition.
+ @par amount The maximum amount to take.
+ @par increment Only multiples of this amount are taken. By default, this is {@c amount},
+                so either everything or nothing is taken.
+ @return int The amount that was taken. The call succeeded completely if this equals {@c amount},
+             and failed if this is 0.
+ @version 0.3.0
+ @related {@link Library_AmmoManager#ReserveAmmo}
+ */
+public func TryConsumeAmmo(id ammo, int amount, int increment)
+{
+	if (g_shooter_checked && ammo == nil)
+	{
+		FatalError("You have to specify a type of ammunition.");
+	}
+
+	increment = Max(1, increment ?? amount);
+	var ammo_source = GetAmmoSource(ammo);
+
+	if (ammo_source == AMMO_Source_Infinite)
+	{
+		return amount;
+	}
+	else if (ammo_source == AMMO_Source_Container)
+	{
+		var owner = this->~GetAmmoContainer();
+
+		if (owner == nil)
+		{
+			FatalError("Could not find the object that should contain the ammunition. Make sure that GetAmmoContainer() returns an existing object.");
+		}
+
+		var taken = owner->~TryConsumeAmmo(ammo, amount, increment);
+		if (taken == nil) // the owner is no ammo manager
+		{
+			taken = Min(amount, owner->~GetAmmo(ammo));
+			taken -= taken % increment;
+			if (taken <= 0)
+			{
+				return 0;
+			}
+			taken = Abs(owner->~DoAmmo(ammo, -taken));
+		}
+		return taken;
+	}
+	else
+	{
+		var before = GetAmmo(ammo);
+		var take = Min(amount, before);
+		take -= take % increment;
+		if (take <= 0)
+		{
+			return 0;
+		}
+		return before - SetAmmo(ammo, before - take);
+	}
+}
+
+/**
+ Reserves ammunition, for example for a burst or for several shots that are fired at once.@br
+ The ammunition is taken right away, see {@link Library_AmmoManager#TryConsumeAmmo},
+ so that nobody else can use it. When the ammunition was used, call {@link Library_AmmoManager#CommitReservation}:
+ this gives back everything that was not used, in a single call.
+ @par ammo The type of the ammunition.
+ @par amount The maximum amount to reserve.
+ @par increment Only multiples of this amount are reserved. By default, this is {@c amount}.
+ @return proplist The reservation, with the properties {@c ammo} and {@c amount},
+                  the amount that was reserved. This can be 0.
+ @version 0.3.0
+ */
+public func ReserveAmmo(id ammo, int amount, int increment)
+{
+	return {
+		ammo = ammo,
+		amount = TryConsumeAmmo(ammo, amount, increment),
+		manager = this, // object - the reservation has to be committed here
+	};
+}
+
+/**
+ Finishes a reservation, see {@link Library_AmmoManager#ReserveAmmo}.
+ The ammunition that was not used is given back.
+ @par reservation The reservation.
+ @par used The amount that was actually used. Pass 0 to cancel the reservation.
+ @return int The amount that was given back.
+ @version 0.3.0
+ */
+public func CommitReservation(proplist reservation, int used)
+{
+	if (reservation.manager != this)
+	{
+		return reservation.manager->CommitReservation(reservation, used);
+	}
+
+	var unused = reservation.amount - BoundBy(used, 0, reservation.amount);
+	reservation.amount = 0;
+	if (unused > 0)
+	{
+		return DoAmmo(reservation.ammo, unused);
+	}
+	return 0;
+}
+
+/**
+ Moves ammunition from one ammo manager to another, for example when reloading.@br
+ The amount is taken from the source in a single call, see {@link Library_AmmoManager#TryConsumeAmmo},
+ and given to the destination. Only if the destination cannot hold all of it, the rest is given back.@br
+ This can be called from the definition: {@c Library_AmmoManager->TransferAmmo(...)}.
+ @par source The object that gives the ammunition.
+ @par destination The object that receives the ammunition.
+ @par ammo The type of the ammunition.
+ @par max The maximum amount to move.
+ @par increment Only multiples of this amount are moved. Default is 1.
+ @return int The amount that was moved.
+ @version 0.3.0
+ */
+public func TransferAmmo(object source, object destination, id ammo, int max, int increment)
+{
+	if (max <= 0)
+	{
+		return 0;
+	}
+
+	var amount = source->TryConsumeAmmo(ammo, max, Max(1, increment));
+	if (amount <= 0)
+	{
+		return 0;
+	}
+
+	var received = destination->DoAmmo(ammo, amount);
+	if (received < amount)
+	{
+		source->DoAmmo(ammo, amount - received);
+	}
+	return received;
+}
+
 /**
  Defines the amount of ammunition that the object currently has.
  @par ammo The type of the ammunition.
@@ -148,12 +375,29 @@ public func SetAmmo(id ammo, int new_value)
 	{
 		var max = ammo->~MaxAmmo() ?? new_value;
 		var value = BoundBy(new_value, 0, max);
-		library_ammo_manager[Format("%i", ammo)] = value;
+		var slot = GetAmmoSlot(ammo);
+		if (library_ammo_manager.ammo[slot] != value)
+		{
+			library_ammo_manager.ammo[slot] = value;
+			// weapons cache the amount, and their fire modes may depend on it
+			this->~UpdateAmmoState(ammo, value);
+			this->~InvalidateAvailableFiremodes();
+			NotifyAmmoChange(ammo);
+		}
 		return value;
 	}
 	else if (ammo_source == AMMO_Source_Items)
 	{
-		FatalError("This is not implemented yet.");
+		var before = GetAmmo(ammo);
+		if (new_value < before)
+		{
+			RemoveAmmoItems(ammo, before - new_value);
+		}
+		else if (new_value > before)
+		{
+			CreateAmmoItems(ammo, new_value - before);
+		}
+		return GetAmmo(ammo);
 	}
 	else if (ammo_source == AMMO_Source_Container)
 	{
@@ -172,6 +416,172 @@ public func SetAmmo(id ammo, int new_value)
 	}
 }
 
+/**
+ Gets the amount of ammunition in an item, for {@c AMMO_Source_Items}.
+ @par item The item.
+ @return int The stack count of the item, or 1 if the item does not stack.
+ @version 0.3.0
+ */
+public func GetAmmoItemAmount(object item)
+{
+	return Max(0, item->~GetStackCount() ?? 1);
+}
+
+/**
+ Counts all items of an ammunition type in the object again, for {@c AMMO_Source_Items}.@br
+ The amount is usually kept up to date when items enter or leave the object, and when a stack
+ reports a change of its count, see {@link Library_AmmoManager#OnInventoryChange}.
+ Call this if the count of an item changes in a way that is not reported.
+ @par ammo The type of the ammunition.
+ @return int The amount of ammunition.
+ @version 0.3.0
+ */
+public func UpdateAmmoItems(id ammo)
+{
+	var amount = 0;
+	for (var item in FindObjects(Find_Container(this), Find_ID(ammo)))
+	{
+		amount += GetAmmoItemAmount(item);
+	}
+	DoAmmoItemCount(ammo, amount - library_ammo_manager.items[GetAmmoSlot(ammo)]);
+	return amount;
+}
+
+/**
+ Counts the ammunition in all items in the object again, after a stack reported
+ a change of its count, see {@link Library_AmmoManager#OnInventoryChange}.
+ @version 0.3.0
+ */
+func UpdateChangedAmmoItems()
+{
+	library_ammo_manager.items_changed = false;
+
+	var counts = [];
+	for (var item in FindObjects(Find_Container(this)))
+	{
+		var ammo = item->GetID();
+		if (GetAmmoSource(ammo) == AMMO_Source_Items)
+		{
+			counts[GetAmmoSlot(ammo)] += GetAmmoItemAmount(item);
+		}
+	}
+
+	var slots = Max(GetLength(counts), GetLength(library_ammo_manager.items));
+	for (var slot = 0; slot < slots; ++slot)
+	{
+		var ammo = g_ammo_slot_types[slot];
+		if (GetAmmoSource(ammo) == AMMO_Source_Items)
+		{
+			DoAmmoItemCount(ammo, counts[slot] - library_ammo_manager.items[slot]);
+		}
+	}
+}
+
+/**
+ Changes the counted amount of ammunition in items.
+ @par ammo The type of the ammunition.
+ @par change The change.
+ @version 0.3.0
+ */
+func DoAmmoItemCount(id ammo, int change)
+{
+	if (change == 0)
+	{
+		return;
+	}
+
+	var slot = GetAmmoSlot(ammo);
+	var value = library_ammo_manager.items[slot] + change;
+	if (value < 0)
+	{
+		// The counter missed a change of a stack, so count again when the ammunition is needed
+		library_ammo_manager.items_changed = true;
+		value = 0;
+	}
+	library_ammo_manager.items[slot] = value;
+
+	// weapons cache the amount, and their fire modes may depend on it
+	this->~UpdateAmmoState(ammo, value);
+	this->~InvalidateAvailableFiremodes();
+	NotifyAmmoChange(ammo);
+}
+
+/**
+ Tells the contained objects that the ammunition of this object changed,
+ by calling {@c OnAmmoContainerChange(object container, id ammo)} in them.
+ Weapons that take their ammunition from this object check the conditions
+ of their fire modes again, see {@link Library_Firearm_AmmoLogic#OnAmmoContainerChange}.
+ @par ammo The type of the ammunition.
+ @version 0.3.0
+ */
+func NotifyAmmoChange(id ammo)
+{
+	for (var i = ContentsCount() - 1; i >= 0; --i)
+	{
+		Contents(i)->~OnAmmoContainerChange(this, ammo);
+	}
+}
+
+/**
+ Takes ammunition from the items in the object. Stacks are reduced,
+ items that are used up are removed.
+ @par ammo The type of the ammunition.
+ @par amount The amount to take.
+ @version 0.3.0
+ */
+func RemoveAmmoItems(id ammo, int amount)
+{
+	while (amount > 0)
+	{
+		var item = FindContents(ammo);
+		if (!item)
+		{
+			break;
+		}
+
+		var available = GetAmmoItemAmount(item);
+		if (available <= amount)
+		{
+			// Counted down in ContentsDestruction
+			amount -= available;
+			item->RemoveObject();
+		}
+		else
+		{
+			// The count is updated right here, the stack does not have to be counted again
+			var changed = library_ammo_manager.items_changed;
+			item->DoStackCount(-amount);
+			library_ammo_manager.items_changed = changed;
+			DoAmmoItemCount(ammo, -amount);
+			amount = 0;
+		}
+	}
+}
+
+/**
+ Creates items with ammunition in the object.
+ @par ammo The type of the ammunition.
+ @par amount The amount to create.
+ @version 0.3.0
+ */
+func CreateAmmoItems(id ammo, int amount)
+{
+	var stack_size = Max(1, ammo->~MaxStackCount() ?? 1);
+	while (amount > 0)
+	{
+		var count = Min(amount, stack_size);
+		var item = CreateObject(ammo, 0, 0, GetOwner());
+		item->~SetStackCount(count);
+		amount -= Max(1, GetAmmoItemAmount(item));
+		// Counted up in Collection2
+		if (!item->Enter(this))
+		{
+			item->RemoveObject();
+			break;
+		}
+	}
+}
+
 /**
  @return an ammunition manager object that handles the ammunition counting
          if {@link Library_AmmoManager#GetAmmoSource} is {@c AMMO_Source_Container}
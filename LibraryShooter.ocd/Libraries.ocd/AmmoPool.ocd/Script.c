@@ -0,0 +1,465 @@
+/**
+ A shared pool of ammunition, for example a depot that supplies a whole team.@br
+ The object should also include {@link Library_AmmoManager}, with {@c AMMO_Source_Local} for the pooled ammunition.
+ Weapons that get their ammunition from the pool ({@c AMMO_Source_Container}) do not ask the pool for every shot.
+ Instead, each weapon gets an allowance: some ammunition that is taken out of the pool in advance,
+ and that the weapon can use up on its own, see {@link Library_AmmoPool#RequestAllowance}.
+ The pool settles all allowances once per frame and refills them. If the pool runs dry,
+ {@link Library_AmmoPool#DistributeAmmo} decides who gets what.
+ Allowances that are not used for a while give their ammunition back, and the pool
+ stops settling once all allowances are idle.
+
+ @author Marky
+ @version 0.3.0
+ */
+
+local library_ammo_pool; // proplist - allowances: array of all allowances; turn: int, rotates the order in which the allowances are served
+
+/* --- Engine callbacks --- */
+
+/**
+ Objects that include this library must call {@link Global#inherited}
+ for this function.
+ */
+public func Construction()
+{
+	library_ammo_pool = library_ammo_pool ?? { allowances = [], turn = 0 };
+	return _inherited(...);
+}
+
+/**
+ Gives back the ammunition of all allowances.
+ Objects that include this library must call {@link Global#inherited}
+ for this function.
+ */
+public func Destruction()
+{
+	for (var allowance in library_ammo_pool.allowances)
+	{
+		allowance.amount = 0;
+		allowance.pool = nil;
+	}
+	library_ammo_pool.allowances = [];
+	return _inherited(...);
+}
+
+/* --- Library code --- */
+
+/**
+ Identifies the object as an ammo pool.
+ @return {@c true}
+ @version 0.3.0
+ */
+public func IsAmmoPool()
+{
+	return true;
+}
+
+/**
+ Opens an allowance for a weapon. The allowance is filled right away, and refilled once per frame.@br
+ The weapon takes ammunition from the allowance with {@c allowance->Draw(amount, increment)},
+ and reads the available ammunition with {@c allowance->GetAvailableAmmo()}. Neither of these contacts the pool.
+ An allowance that was not used for a while becomes idle and gives its ammunition back;
+ {@c allowance->Request(amount)} refills an idle allowance right away.
+ @par member The object that uses the allowance, usually a weapon.
+ @par ammo The type of the ammunition.
+ @par usage The weapon takes ammunition in multiples of this amount, default is 1.
+ @par window The allowance stays active for at least this many frames after it was used,
+             for example the time between two shots of the weapon. See {@link Library_AmmoPool#GetAllowanceWindow}.
+ @return proplist The allowance.
+ @version 0.3.0
+ */
+public func RequestAllowance(object member, id ammo, int usage, int window)
+{
+	var allowance = {
+		Prototype = AmmoAllowance,
+		pool = this,      // object - the pool that refills the allowance
+		member = member,  // object - the object that uses the allowance
+		ammo = ammo,      // id - the type of the ammunition
+		usage = Max(1, usage), // int - the ammunition is taken in multiples of this amount
+		window = window,  // int, frames - the allowance stays active for at least this long after it was used
+		amount = 0,       // int - the ammunition that can be used
+		drawn = 0,        // int - the ammunition that was used since the last settlement
+		demand = 0,       // int - the ammunition that was used in the last frame with a shot; 0 if the allowance is idle
+		used = 0,         // int, frame - the allowance was used in this frame
+	};
+	PushBack(library_ammo_pool.allowances, allowance);
+
+	// Fill it now, so that the weapon does not have to wait for the first settlement
+	RefillAllowance(allowance, allowance.usage);
+	return allowance;
+}
+
+/**
+ Refills a single allowance right away, outside of the settlement. This is meant for allowances
+ that were idle and are used again, see {@c allowance->Request(amount)}; active allowances
+ are refilled by the settlement. If the pool does not have enough ammunition,
+ {@link Library_AmmoPool#DistributeAmmo} decides how much the allowance gets.
+ @par allowance The allowance, see {@link Library_AmmoPool#RequestAllowance}.
+ @par amount The allowance should hold at least this amount.
+ @version 0.3.0
+ */
+public func RefillAllowance(proplist allowance, int amount)
+{
+	allowance.demand = Max(allowance.demand, amount);
+	allowance.used = FrameCounter();
+
+	var missing = GetAllowanceRequest(allowance);
+	if (missing > 0)
+	{
+		var available = this->GetAmmo(allowance.ammo);
+		if (available < missing)
+		{
+			var allowances = GetAllowances(allowance.ammo);
+			var requests = [];
+			for (var other in allowances)
+			{
+				PushBack(requests, GetAllowanceRequest(other));
+			}
+			var grants = this->DistributeAmmo(allowance.ammo, allowances, requests, available);
+			missing = grants[GetIndexOf(allowances, allowance)] ?? 0;
+		}
+		if (missing > 0)
+		{
+			allowance.amount += this->TryConsumeAmmo(allowance.ammo, missing, 1);
+		}
+	}
+	WakeSettlement();
+}
+
+/**
+ Closes an allowance. The ammunition that was not used goes back to the pool.
+ @par allowance The allowance, see {@link Library_AmmoPool#RequestAllowance}.
+ @version 0.3.0
+ */
+public func ReleaseAllowance(proplist allowance)
+{
+	var index = GetIndexOf(library_ammo_pool.allowances, allowance);
+	if (index >= 0)
+	{
+		RemoveArrayIndex(library_ammo_pool.allowances, index);
+	}
+	if (allowance.amount > 0)
+	{
+		this->DoAmmo(allowance.ammo, allowance.amount);
+	}
+	allowance.amount = 0;
+	allowance.pool = nil;
+}
+
+/**
+ The amount of ammunition that an allowance should hold after a settlement.
+ @par allowance The allowance.
+ @return int The amount. By default, this is twice the recent demand, but at least 5 and at least
+         the ammo usage of the weapon. An idle allowance, without demand, gets nothing.
+         Overload this for a custom behaviour.
+ @version 0.3.0
+ */
+public func GetAllowanceTarget(proplist allowance)
+{
+	if (allowance.demand <= 0)
+	{
+		return 0;
+	}
+	return Max(Max(5, allowance.usage), 2 * allowance.demand);
+}
+
+/**
+ The amount of ammunition that is missing in an allowance.
+ @par allowance The allowance.
+ @return int The difference to {@link Library_AmmoPool#GetAllowanceTarget}, at least 0.
+ @version 0.3.0
+ */
+func GetAllowanceRequest(proplist allowance)
+{
+	return Max(0, this->GetAllowanceTarget(allowance) - allowance.amount);
+}
+
+/**
+ The time that an allowance stays active after it was used. An allowance that was
+ not used for longer than this becomes idle and gives back its ammunition.
+ @par allowance The allowance.
+ @return int The time in frames. By default, this is the window of the allowance,
+         but at least 10 frames. Overload this for a custom behaviour.
+ @version 0.3.0
+ */
+public func GetAllowanceWindow(proplist allowance)
+{
+	return Max(10, allowance.window);
+}
+
+/**
+ Gets all allowances for a type of ammunition.
+ @par ammo The type of the ammunition.
+ @return array The allowances.
+ @version 0.3.0
+ */
+func GetAllowances(id ammo)
+{
+	var allowances = [];
+	for (var allowance in library_ammo_pool.allowances)
+	{
+		if (allowance.ammo == ammo)
+		{
+			PushBack(allowances, allowance);
+		}
+	}
+	return allowances;
+}
+
+/**
+ Fairness policy: decides how much ammunition each allowance gets.
+ This is called once per frame and ammunition type, even if there is enough for everyone.@br
+ By default, everyone gets an equal share of what is available, but not more than requested.
+ The rest of a share that cannot be divided goes to the allowances in turn.
+ Overload this for a custom behaviour.
+ @par ammo The type of the ammunition.
+ @par allowances The allowances for this ammunition type.
+ @par requests The amount that each allowance requests, with the same indices as {@c allowances}.
+ @par available The amount that the pool has.
+ @return array The amount that each allowance gets, with the same indices as {@c allowances}. The sum must not exceed {@c available}.
+ @version 0.3.0
+ */
+public func DistributeAmmo(id ammo, array allowances, array requests, int available)
+{
+	var count = GetLength(requests);
+	var grants = CreateArray(count);
+	var open = 0;
+	for (var i = 0; i < count; ++i)
+	{
+		grants[i] = 0;
+		if (requests[i] > 0)
+		{
+			open += 1;
+		}
+	}
+
+	var turn = library_ammo_pool.turn;
+	while (available > 0 && open > 0)
+	{
+		var share = Max(1, available / open);
+		for (var n = 0; n < count && available > 0; ++n)
+		{
+			var index = (turn + n) % count;
+			var missing = requests[index] - grants[index];
+			if (missing > 0)
+			{
+				var grant = Min(Min(share, missing), available);
+				grants[index] += grant;
+				available -= grant;
+				if (grant == missing)
+				{
+					open -= 1;
+				}
+			}
+		}
+	}
+	library_ammo_pool.turn = turn + 1;
+	return grants;
+}
+
+/**
+ Settles all allowances: removes allowances whose member is gone, refills the others,
+ and takes back the ammunition of idle allowances.
+ Called once per frame while there are allowances that are not idle.
+ @version 0.3.0
+ */
+public func SettleAllowances()
+{
+	var types = [];
+	var active = false;
+	for (var i = GetLength(library_ammo_pool.allowances) - 1; i >= 0; --i)
+	{
+		var allowance = library_ammo_pool.allowances[i];
+		if (!allowance.member)
+		{
+			ReleaseAllowance(allowance);
+			continue;
+		}
+
+		// Remember how much was used, for the target; forget it if nothing was used for a while
+		if (allowance.drawn > 0)
+		{
+			allowance.demand = allowance.drawn;
+			allowance.used = FrameCounter();
+		}
+		else if (allowance.demand > 0 && FrameCounter() - allowance.used > this->GetAllowanceWindow(allowance))
+		{
+			allowance.demand = 0;
+			// The member can use the pool directly now
+			allowance.member->~OnAmmoContainerChange(this, allowance.ammo);
+		}
+		allowance.drawn = 0;
+
+		// Take back what is not needed anymore
+		var excess = allowance.amount - this->GetAllowanceTarget(allowance);
+		if (excess > 0)
+		{
+			allowance.amount -= excess;
+			this->DoAmmo(allowance.ammo, excess);
+		}
+
+		if (allowance.demand > 0)
+		{
+			active = true;
+		}
+
+		if (GetIndexOf(types, allowance.ammo) < 0)
+		{
+			PushBack(types, allowance.ammo);
+		}
+	}
+
+	for (var ammo in types)
+	{
+		var allowances = GetAllowances(ammo);
+		var requests = [];
+		for (var allowance in allowances)
+		{
+			PushBack(requests, GetAllowanceRequest(allowance));
+		}
+
+		var grants = this->DistributeAmmo(ammo, allowances, requests, this->GetAmmo(ammo));
+		var total = 0;
+		for (var grant in grants)
+		{
+			total += grant;
+		}
+		if (total <= 0)
+		{
+			continue;
+		}
+
+		// A single call to the ledger for all allowances
+		var received = this->TryConsumeAmmo(ammo, total, 1);
+		for (var index = 0; index < GetLength(allowances); ++index)
+		{
+			var share = Min(grants[index], received);
+			if (share > 0 && allowances[index].amount <= 0)
+			{
+				// The member can use the allowance again
+				allowances[index].member->~OnAmmoContainerChange(this, ammo);
+			}
+			allowances[index].amount += share;
+			received -= share;
+		}
+	}
+
+	// Sleep while nobody uses the pool
+	if (active)
+	{
+		WakeSettlement();
+	}
+	else
+	{
+		var effect = GetEffect("IntAmmoPoolSettlement", this);
+		if (effect)
+		{
+			effect.Interval = 0;
+		}
+	}
+}
+
+/**
+ Makes sure that the allowances are settled in the next frame.
+ @version 0.3.0
+ */
+func WakeSettlement()
+{
+	var effect = GetEffect("IntAmmoPoolSettlement", this) ?? CreateEffect(IntAmmoPoolSettlement, 1, 1);
+	effect.Interval = 1;
+}
+
+local IntAmmoPoolSettlement = new Effect {
+	Timer = func()
+	{
+		this.Target->SettleAllowances();
+		return FX_OK;
+	}
+};
+
+/**
+ Prototype for allowances, see {@link Library_AmmoPool#RequestAllowance}.
+ */
+local AmmoAllowance = {
+	/**
+	 Takes ammunition from the allowance, without contacting the pool.
+	 @par amount The maximum amount to take.
+	 @par increment Only multiples of this amount are taken. By default, this is {@c amount}.
+	 @return int The amount that was taken.
+	 */
+	Draw = func(int amount, int increment)
+	{
+		increment = Max(1, increment ?? amount);
+		var take = Min(amount, this.amount);
+		take -= take % increment;
+		if (take <= 0)
+		{
+			return 0;
+		}
+		this.amount -= take;
+		this.drawn += take;
+		return take;
+	},
+
+	/**
+	 Refills the allowance right away if it is idle and holds less than the requested amount.
+	 An active allowance is not refilled before the next settlement.
+	 @par amount The requested amount.
+	 @return int The amount that can be used now.
+	 */
+	Request = func(int amount)
+	{
+		if (this.amount < amount && this->IsIdle() && this.pool)
+		{
+			this.pool->RefillAllowance(this, amount);
+		}
+		return this.amount;
+	},
+
+	/**
+	 Gets the amount of ammunition that can be used, without changing anything.
+	 @return int The amount in the allowance. An idle allowance can also use the ammunition in the pool.
+	 */
+	GetAvailableAmmo = func()
+	{
+		if (this->IsIdle() && this.pool)
+		{
+			return this.amount + this.pool->GetAmmo(this.ammo);
+		}
+		return this.amount;
+	},
+
+	/**
+	 An allowance is idle if it was not used for a while, see {@link Library_AmmoPool#GetAllowanceWindow}.
+	 @return bool {@c true} if the allowance is idle.
+	 */
+	IsIdle = func()
+	{
+		return this.demand <= 0;
+	},
+
+	/**
+	 Gives back ammunition that was drawn, but not used.
+	 @par amount The amount.
+	 @return int The amount that was given back.
+	 */
+	Refund = func(int amount)
+	{
+		amount = Max(0, amount);
+		this.amount += amount;
+		this.drawn = Max(0, this.drawn - amount);
+		return amount;
+	},
+
+	/**
+	 Closes the allowance, see {@link Library_AmmoPool#ReleaseAllowance}.
+	 */
+	Release = func()
+	{
+		if (this.pool)
+		{
+			this.pool->ReleaseAllowance(this);
+		}
+	},
+};
@@ -7,6 +7,7 @@
 	After that, one shot will be fired. A shot can, however, fire multiple projectiles at once (e.g. firing a shotgun).@br
 	The weapon will then start the recovery process if needed. Recovery is the delay between two consecutive shots and is therefore only necessary for automatic or burst fire modes. The weapon will go over to firing shots again after recovery finished.@br
 	Last, the cooldown procedure will start. Weapons cannot fire again until the cooldown has been finished. Example: A powerful railgun that needs some time to cool off after a shot.@br
+	All of these stages are driven by a single effect per weapon, see {@link Library_Firearm#GetWeaponState}. The effect sleeps until the next stage is due, instead of checking every frame.@br
 	@note Fire modes
 	Each weapon must define at least one fire mode. fire_mode_default provides an example of how these could look and should also be used as a Prototype, to provide default values.@br
 	A fire mode is a proplist that can define the following properties:@br
@@ -14,6 +15,7 @@
 	- WEAPON_FM_Single: single shot style, only shot per click is fired (default).@br
 	- WEAPON_FM_Burst: burst style, firing a set number of shot in short succession.@br
 	- WEAPON_FM_Auto: auto style, firing as long as the use button is pressed.@br
+	- WEAPON_FM_Beam: beam style, a single continuous beam that deals damage in intervals as long as the use button is pressed.@br
 	name: A string containing the name of this fire mode. Unnecessary if no GUI exists that displays the name (default: Standard).@br
 	icon: ID of a definition icon for the fire mode. Unnecessary if no GUI exists that displays the icon (default: nil).@br
 	condition: A string corresponding to a function name. The fire mode will not be marked as 'available' unless the condition functions return true. Example: An upgraded weapon could offer more fire modes (default: nil).@br
@@ -21,21 +23,29 @@
 	ammo_usage: Integer. How much ammunition is needed per ammo_rate shots (default: 1).@br
 	ammo_rate: Integer. See ammo_usage (default: 1). As ammo handling is not part the library, this has to be implemented (or include {@link Library_Firearm_AmmoLogic}).@br
 	delay_charge: Integer. Charge duration in frames. If 0 or nil, no charge is required (default: 0).@br
-	delay_recover: Integer. Recovery duration in frames. If 0 or nil, no recovery is required (default: 1).@br
+	delay_recover: Integer. Recovery duration in frames. If 0 or nil, no recovery is required. In beam mode style this is the interval between two damage ticks (default: 1).@br
+	rate: Integer. Fire rate in shots per minute. If set, this replaces delay_recover for all but the beam mode style. Rates of more than one shot per frame are possible, the shots that are due in the same frame are fired together (default: nil).@br
 	delay_cooldown: Integer. Cooldown duration in frames. If 0 or nil, no cooldown is required (default: 0).@br
 	delay_reload: Integer. Reload duration in frames. If 0 or nil, reloading is instantaneous (default: 0).@br
+	heat_per_shot: Integer. The weapon heats up by this much with every shot. If 0 or nil, the weapon does not heat up (default: 0).@br
+	heat_decay: Integer. The heat decreases by this much per second (default: 0).@br
+	heat_limit: Integer. If the heat reaches this value, the weapon overheats and cools down completely before it can fire again (default: 100).@br
 	damage: Integer. Amount of damage a projectile does (default: 10).@br
 	damage_type: Integer. Defining a damage type. Damage type handling is not done by this library and should be handled by any implementation (default: nil).@br
 	projectile_id: A definition of the actual projectile that is being fired. These are created on the fly and must therefore not be created beforehand (default: NormalBullet).@br
+	beam_id: A definition of the beam that is displayed in beam mode style. Should behave like {@link LaserEffect} (default: LaserEffect).@br
 	projectile_speed: Integer. Firing speed of a projectile (default: 100).@br
 	projectile_range: Integer. Maximum range a projectile flies (default: 600).@br
 	projectile_distance: Integer. Distance the projectile is being created away from the shooting object (default: 10).@br
 	projectile_offset_y: Integer. Y offset when creating a projectile in case the barrel of the gun is not perfectly aligned to the firing object's center (default: -6).@br
 	projectile_number: Integer. How many projectiles are fired in a single shot (default: 1).@br
-	projectile_spread: Proplist with two integers. Deviation of a projectile from the firing angle and a precision parameter.@br
+	projectile_spread: Proplist with two integers. Deviation of a projectile from the firing angle and a precision parameter, and optionally a distribution, see {@link Global#Projectile_Deviation}.@br
 	spread: Proplist with two integers. Additional deviation added by certain effects (e.g. continuous firing) (default: { angle: 1, precision: 100 }).@br
-	burst: Integer. Number of shots being fired when using burst mode style (default: 0).@br
+	spread_limit: Integer. If set, the spread blooms: it grows by the spread angle with every shot, up to this value, and decays over time. If nil, the spread is always applied fully (default: nil).@br
+	spread_decay: Integer. The spread from prolonged firing decreases by this much per second, in the precision of the spread (default: 0).@br
+	burst: Integer. Number of shots being fired when using burst mode style. The shots are fired in intervals of delay_recover, the ammo for all of them is taken with the first shot (default: 0).@br
 	auto_reload: Boolean. If true, the weapon reloads even if the use button is not held (default: false).@br
+	reload_step: Integer. If set, the weapon reloads this many rounds at a time, for example shell by shell. Each step takes delay_reload frames, and pulling the trigger interrupts reloading after a step (default: 0).@br
 	anim_shoot_name: A string containing the animation name that is returned for the animation set (usually when being used by a Clonk) as general aim animation (default: nil).@br
 	anim_load_name: A string containing the animation name that is returned for the animation set (usually when being used by a Clonk) as general reload animation (default: nil).@br
 	walk_speed_front: Integer. Forwards walking speed to be returned for the animation set (usually when being used by a Clonk) (default: nil).@br
@@ -52,6 +62,18 @@ local is_using = false;    // bool: is the user holding the fire button
 static const WEAPON_FM_Single = 1;
 static const WEAPON_FM_Burst  = 2;
 static const WEAPON_FM_Auto   = 3;
+static const WEAPON_FM_Beam   = 4;
+
+static const WEAPON_State_Idle       = 1;
+static const WEAPON_State_Charging   = 2;
+static const WEAPON_State_Firing     = 3;
+static const WEAPON_State_Recovering = 4;
+static const WEAPON_State_Cooling    = 5;
+static const WEAPON_State_Reloading  = 6;
+static const WEAPON_State_Locked     = 7;
+
+static const WEAPON_FramesPerMinute = 2160; // for fire rates in shots per minute
+static const WEAPON_FramesPerSecond = 36;   // for heat decay per second
 
 local fire_modes = [fire_mode_default];
 
@@ -66,11 +88,16 @@ local fire_mode_default =
 	ammo_rate =           1, // int - per this many shots fired
 	delay_charge =        0, // int, frames - time that the button must be held before the shot is fired
 	delay_recover =       1, // int, frames - time between consecutive shots
+	rate =                nil, // int, shots per minute - replaces delay_recover if set
 	delay_cooldown =      0, // int, frames - time of cooldown after the last shot is fired
 	delay_reload =        0, // int, frames - time to reload
+	heat_per_shot =       0, // int - heat that is added per shot
+	heat_decay =          0, // int, per second - heat that is removed over time
+	heat_limit =          100, // int - the weapon overheats at this heat
 	damage =              10,
 	damage_type =         nil,
 	projectile_id =       NormalBullet,
+	beam_id =             LaserEffect, // id - the beam in beam mode
 	projectile_speed =    100,
 	projectile_range =    600,
 	projectile_distance = 10,
@@ -78,8 +105,11 @@ local fire_mode_default =
 	projectile_number =   1,
 	projectile_spread =   { angle: 0, precision: 100 }, // default inaccuracy of a single projectile
 	spread =              { angle: 1, precision: 100 }, // inaccuracy from prolonged firing
+	spread_limit =        nil, // int - maximum spread from prolonged firing, nil if the spread does not bloom
+	spread_decay =        0, // int, per second - spread that is removed over time
 	burst =               0, // number of projectiles fired in a burst
 	auto_reload =         false, // the weapon should "reload itself", i.e not require the user to hold the button when it reloads
+	reload_step =         0, // int - rounds loaded per reload step, 0 for loading everything at once
 	anim_shoot_name =     nil, // for animation set: shoot animation
 	anim_load_name =      nil, // for animation set: reload animation
 	walk_speed_front =    nil, // for animation set: relative walk speed
@@ -95,8 +125,16 @@ local weapon_properties =
 	gfx_offset_y = -6,
 };
 
-local shot_counter; // proplist
+local shot_counter; // array - shots fired per fire mode slot, see GetFiremodeSlot
 local selected_firemode; // int
+local firearm_beam; // object - the beam of a beam fire mode, while it is being fired
+local muzzle_flash_light; // object - the light of the muzzle flash, re-triggered on every shot
+local muzzle_flash_particles; // proplist - particle presets for the muzzle flash, reused on every shot
+local compiled_firemodes; // array - flat copies of the fire modes, see GetCompiledFiremode
+local available_firemodes; // proplist - cached available fire modes, see GetAvailableFiremodes
+local sample_seed; // int - seed for the sample tables of the fire modes, nil for engine random values
+local sound_voices; // array - frames at which the weapon started sounds
+local sustained_fire_sound; // string - looping sound that plays while firing continuously
 
 local animation_set = {
 	AimMode        = AIM_Position, // The aiming animation is done by adjusting the animation position to fit the angle
@@ -133,7 +171,7 @@ public func Setting_AimOnUseStart()
 */
 func FireOnHolding()
 {
-	return !Setting_AimOnUseStart() || GetFiremode().mode == WEAPON_FM_Auto;
+	return !Setting_AimOnUseStart() || FiresContinuously(GetFiremode());
 }
 
 /**
@@ -143,7 +181,18 @@ func FireOnHolding()
 */
 func FireOnStopping()
 {
-	return Setting_AimOnUseStart() && GetFiremode().mode != WEAPON_FM_Auto;
+	return Setting_AimOnUseStart() && !FiresContinuously(GetFiremode());
+}
+
+/**
+ Check if a fire mode fires as long as the use button is held.
+ @par firemode A proplist containing the fire mode information.
+ @return {@c true} if the fire mode is an automatic or a beam fire mode.
+ @version 0.3.0
+*/
+func FiresContinuously(proplist firemode)
+{
+	return firemode.mode == WEAPON_FM_Auto || firemode.mode == WEAPON_FM_Beam;
 }
 
 /**
@@ -164,12 +213,44 @@ public func Setting_WithAmmoLogic()
 */
 func Initialize()
 {
-	shot_counter = {};
+	shot_counter = [];
 	selected_firemode = 0;
 
 	_inherited();
 }
 
+/**
+ Make sure to call this via _inherited();
+*/
+func Destruction()
+{
+	StopBeam();
+	StopSustainedFireSound();
+	if (muzzle_flash_light) muzzle_flash_light->RemoveObject();
+
+	_inherited(...);
+}
+
+/**
+ Make sure to call this via _inherited();
+*/
+func Entrance(object container)
+{
+	InvalidateAvailableFiremodes();
+
+	_inherited(container, ...);
+}
+
+/**
+ Make sure to call this via _inherited();
+*/
+func Departure(object container)
+{
+	InvalidateAvailableFiremodes();
+
+	_inherited(container, ...);
+}
+
 /*-- Controls --*/
 
 /**
@@ -189,6 +270,8 @@ public func ControlUseStart(object user, int x, int y)
 		FatalError("The function expects a user that is not nil");
 	}
 
+	InterruptReload(user, x, y);
+
 	this->OnPressUse(user, x, y);
 
 	return true;
@@ -292,7 +375,10 @@ public func ControlUseAltHolding(object user, int x, int y)
  - call {@link Library_Firearm#OnUseStop}@br
  - check {@link Library_Firearm#FireOnStopping} and if true, stop aiming, leave the rest to {@link Library_Firearm#FinishedAiming}, otherwise do the following:@br
  - still stop aiming if {@link Library_Firearm#Setting_AimOnUseStart} is true.@br
+ - if a burst is being fired, let it finish and do nothing else, see {@link Library_Firearm#IsFiringBurst}@br
  - call {@link Library_Firearm#CancelUsing}@br
+ - call {@link Library_Firearm#StopBeam}@br
+ - call {@link Library_Firearm#StopSustainedFireSound}@br
  - call {@link Library_Firearm#CancelCharge}@br
  - call {@link Library_Firearm#CancelReload}@br
  - check if the weapon is not {@link Library_Firearm#IsRecovering} and if not, call {@link Library_Firearm#CheckCooldown}@br
@@ -316,7 +402,16 @@ public func ControlUseStop(object user, int x, int y)
 
 	if (FireOnHolding())
 	{
+		if (IsFiringBurst())
+		{
+			// The burst is finished although the button was released, CancelUsing() would stop it
+			is_using = false;
+			return true;
+		}
+
 		CancelUsing();
+		StopBeam(user, GetFiremode());
+		StopSustainedFireSound();
 
 		CancelCharge(user, x, y, GetFiremode(), true);
 		CancelReload(user, x, y, GetFiremode(), true);
@@ -352,6 +447,7 @@ public func ControlUseAltStop(object user, int x, int y)
 
  The function does the following:@br
  - call {@link Library_Firearm#OnUseCancel}@br
+ - call {@link Library_Firearm#CancelBurst}@br
  - call {@link Library_Firearm#ControlUseStop}@br
  @par user The object that is using the weapon.
  @par x The x coordinate the user is aiming at. Relative to the user.
@@ -363,6 +459,7 @@ public func ControlUseCancel(object user, int x, int y)
 	if (this->OnUseCancel(user, x, y))
 		return true;
 
+	CancelBurst();
 	return ControlUseStop(user, x, y);
 }
 
@@ -384,12 +481,13 @@ public func ControlUseAltCancel(object user, int x, int y)
 }
 
 /**
- Sets is_using to false.
- @version 0.2.0
+ Sets is_using to false and stops a burst that is being fired ({@link Library_Firearm#CancelBurst}).
+ @version 0.3.0
 */
 public func CancelUsing()
 {
 	is_using = false;
+	CancelBurst();
 }
 
 /**
@@ -518,6 +616,275 @@ public func OnUseAltCancel(object user, int x, int y)
 {
 }
 
+/*-- Weapon Cycle --*/
+
+/**
+ Gets the state of the weapon.
+ @return int One of the following constants:@br
+ - WEAPON_State_Idle: the weapon is doing nothing.@br
+ - WEAPON_State_Charging: the weapon is charging, see {@link Library_Firearm#StartCharge}.@br
+ - WEAPON_State_Firing: the weapon is firing a shot, see {@link Library_Firearm#Fire}.@br
+ - WEAPON_State_Recovering: the weapon is recovering between two shots, see {@link Library_Firearm#FireRecovery}.@br
+ - WEAPON_State_Cooling: the weapon is cooling down, see {@link Library_Firearm#StartCooldown}.@br
+ - WEAPON_State_Reloading: the weapon is reloading, see {@link Library_Firearm#StartReload}.@br
+ - WEAPON_State_Locked: the weapon is locked, see {@link Library_Firearm#LockWeapon}.@br
+ @version 0.3.0
+*/
+public func GetWeaponState()
+{
+	if (IsWeaponLocked())
+	{
+		return WEAPON_State_Locked;
+	}
+	return GetWeaponCycle().state;
+}
+
+/**
+ Gets the effect that drives the weapon cycle.@br
+ The effect holds the state of the weapon and the processes that take some time: charging, recovering, cooling down, reloading, and the lock.
+ Each process is a proplist with the user, the aiming coordinates and the fire mode, the frame when it started,
+ its duration, and the frame when it is due next. The effect sleeps until the earliest of these frames.
+ @return proplist The effect. It is created if it does not exist yet.
+ @version 0.3.0
+*/
+func GetWeaponCycle()
+{
+	return GetEffect("IntWeaponCycle", this) ?? CreateEffect(IntWeaponCycle, 1, 0);
+}
+
+/**
+ Starts a process in the weapon cycle, replacing a process of the same kind. The process is due after its duration,
+ but the weapon cycle is not scheduled yet, so that the process can still be modified. Call {@link Library_Firearm#ScheduleWeaponCycle} afterwards.
+ @par name The kind of the process: "charge", "burst", "recovery", "cooldown", or "reload".
+ @par state The state of the weapon while the process runs.
+ @par user The object that is using the weapon.
+ @par x The x coordinate the user is aiming at. Relative to the user.
+ @par y The y coordinate the user is aiming at. Relative to the user.
+ @par firemode A proplist containing the fire mode information.
+ @par duration The duration of the process, in frames.
+ @return proplist The process.
+ @version 0.3.0
+*/
+func StartWeaponProcess(string name, int state, object user, int x, int y, proplist firemode, int duration)
+{
+	var cycle = GetWeaponCycle();
+	var process = {
+		user = user,
+		x = x,
+		y = y,
+		firemode = firemode,
+		state = state,
+		start = FrameCounter(),     // int, frame - the process started at this frame
+		duration = duration,        // int, frames - the process takes this long
+		wake = FrameCounter() + duration, // int, frame - the process is due at this frame, nil if it is never due
+		percent_old = 0,
+		percentage = 0,
+		progress = 0,
+	};
+	cycle[name] = process;
+	cycle.state = state;
+	return process;
+}
+
+/**
+ Stops a process in the weapon cycle. If the weapon is in the state of that process, it becomes idle.
+ @par name The kind of the process, see {@link Library_Firearm#StartWeaponProcess}.
+ @return proplist The process that was stopped, or {@c nil}.
+ @version 0.3.0
+*/
+func StopWeaponProcess(string name)
+{
+	var cycle = GetWeaponCycle();
+	var process = cycle[name];
+	cycle[name] = nil;
+	if (process && cycle.state == process.state)
+	{
+		cycle.state = WEAPON_State_Idle;
+	}
+	return process;
+}
+
+/**
+ Gets the progress of a process in the weapon cycle.
+ @par process The process.
+ @return int A value of 0 to 100.
+ @version 0.3.0
+*/
+func GetProcessProgress(proplist process)
+{
+	return BoundBy((FrameCounter() - process.start) * 100 / Max(1, process.duration), 0, 100);
+}
+
+/**
+ Lets the weapon cycle sleep until the next process is due.@br
+ This is called after every transition of the weapon state, so it also applies a scheduled fire mode change
+ ({@link Library_Firearm#ScheduleSetFiremode}) as soon as the new state allows it.
+ @version 0.3.0
+*/
+func ScheduleWeaponCycle()
+{
+	var cycle = GetWeaponCycle();
+	var wake = nil;
+
+	ApplyScheduledFiremode();
+
+	for (var process in [cycle.charge, cycle.burst, cycle.recovery, cycle.cooldown, cycle.reload])
+	{
+		if (process && process.wake != nil && (wake == nil || process.wake < wake))
+		{
+			wake = process.wake;
+		}
+	}
+
+	// A locked weapon needs to wake up only if a fire mode change waits for the lock to expire;
+	// an expired lock is removed, so that it cannot wake the cycle every frame
+	var lock = cycle.lock;
+	if (lock && lock.until != nil && lock.until <= FrameCounter())
+	{
+		cycle.lock = nil;
+		lock = nil;
+	}
+	if (cycle.scheduled_firemode != nil && lock && lock.until != nil && (wake == nil || lock.until < wake))
+	{
+		wake = lock.until;
+	}
+
+	if (wake == nil)
+	{
+		cycle.Interval = 0;
+	}
+	else
+	{
+		cycle.Time = 0;
+		cycle.Interval = Max(1, wake - FrameCounter());
+	}
+}
+
+/**
+ Advances the processes in the weapon cycle that are due. Called by the weapon cycle effect.
+ @version 0.3.0
+*/
+func ExecuteWeaponCycle()
+{
+	var cycle = GetWeaponCycle();
+	var frame = FrameCounter();
+
+	var charge = cycle.charge;
+	if (charge && charge.wake != nil && frame >= charge.wake)
+	{
+		ProgressCharge(charge);
+	}
+
+	var reload = cycle.reload;
+	if (reload && reload.wake != nil && frame >= reload.wake)
+	{
+		ProgressReload(reload);
+	}
+
+	var burst = cycle.burst;
+	if (burst && frame >= burst.wake)
+	{
+		FireBurstRound(burst);
+	}
+
+	var recovery = cycle.recovery;
+	if (recovery && frame >= recovery.wake)
+	{
+		StopWeaponProcess("recovery");
+		DoRecovery(recovery.user, recovery.x, recovery.y, recovery.firemode);
+	}
+
+	var cooldown = cycle.cooldown;
+	if (cooldown && frame >= cooldown.wake)
+	{
+		StopWeaponProcess("cooldown");
+		if (cooldown.overheat)
+		{
+			// Heat without decay is removed only when the overheat lockout ends
+			cycle.heat = nil;
+		}
+		DoCooldown(cooldown.user, cooldown.firemode);
+	}
+
+	// Also applies a fire mode change that waited for the lock to expire
+	ScheduleWeaponCycle();
+}
+
+/**
+ Defines when {@link Library_Firearm#OnProgressCharge} and {@link Library_Firearm#OnProgressReload} are called.
+ The weapon cycle computes the frames where the progress reaches these thresholds, and sleeps in between.
+ @par firemode A proplist containing the fire mode information.
+ @return An {@c int}: the callbacks happen each time the progress increased by this many percent,@br
+         or an {@c array} of percentages: the callbacks happen only when the progress reaches one of these milestones.@br
+         The default is 1, so the callbacks happen whenever the percentage changes. Overload this function for custom behaviour.
+ @version 0.3.0
+*/
+public func GetProgressGranularity(proplist firemode)
+{
+	return 1;
+}
+
+/**
+ Gets the next progress threshold, see {@link Library_Firearm#GetProgressGranularity}.
+ @par firemode A proplist containing the fire mode information.
+ @par percent The progress that was reported last, in percent.
+ @return int The next threshold, in percent, or {@c nil} if no further progress is reported.
+ @version 0.3.0
+*/
+func GetNextProgressThreshold(proplist firemode, int percent)
+{
+	var granularity = this->GetProgressGranularity(firemode);
+
+	if (GetType(granularity) == C4V_Array)
+	{
+		var next = nil;
+		for (var milestone in granularity)
+		{
+			if (milestone > percent && milestone <= 100 && (next == nil || milestone < next))
+			{
+				next = milestone;
+			}
+		}
+		return next;
+	}
+
+	if (percent >= 100)
+	{
+		return nil;
+	}
+
+	granularity = Max(1, granularity);
+	return Min(100, (percent / granularity + 1) * granularity);
+}
+
+/**
+ Gets the frame where a process reaches its next progress threshold.
+ @par process The process, see {@link Library_Firearm#GetWeaponCycle}.
+ @return int The first frame where the progress reaches the threshold, or {@c nil} if there is no further threshold.
+ @version 0.3.0
+*/
+func GetNextProgressFrame(proplist process)
+{
+	var threshold = GetNextProgressThreshold(process.firemode, process.percent_old);
+	if (threshold == nil)
+	{
+		return nil;
+	}
+	return process.start + (threshold * Max(1, process.duration) + 99) / 100;
+}
+
+local IntWeaponCycle = new Effect {
+	Construction = func()
+	{
+		this.state = WEAPON_State_Idle;
+	},
+	Timer = func()
+	{
+		this.Target->ExecuteWeaponCycle();
+		return FX_OK;
+	}
+};
+
 /*-- Charging --*/
 
 /**
@@ -538,7 +905,7 @@ func StartCharge(object user, int x, int y)
 {
 	var firemode = GetFiremode();
 
-	if (firemode == nil)
+	if (g_shooter_checked && firemode == nil)
 	{
 		FatalError(Format("Fire mode '%s' not supported", firemode));
 	}
@@ -551,6 +918,15 @@ func StartCharge(object user, int x, int y)
 	{
 		if (effect.user == user && effect.firemode == firemode)
 		{
+			effect.x = x; // x and y are passed to the progress callbacks
+			effect.y = y;
+
+			// Check if the charging process is finished based on the charging delay of the firemode
+			if (FrameCounter() - effect.start > effect.duration)
+			{
+				effect.is_charged = true;
+			}
+
 			if (effect.has_charged)
 			{
 				return false; // fire away
@@ -569,12 +945,7 @@ func StartCharge(object user, int x, int y)
 			}
 			else
 			{
-				if (effect.progress > 0)
-				{
-					this->OnProgressCharge(user, x, y, firemode, effect.percentage, effect.progress);
-					effect.percent_old = effect.percentage;
-				}
-				return true; // keep charging
+				return true; // keep charging, the progress is reported by the weapon cycle
 			}
 		}
 		else
@@ -583,7 +954,12 @@ func StartCharge(object user, int x, int y)
 		}
 	}
 
-	CreateEffect(IntChargeEffect, 1, 1, user, firemode);
+	// The weapon cycle wakes up only for the progress callbacks, the end of charging is checked whenever the weapon is used
+	var charge = StartWeaponProcess("charge", WEAPON_State_Charging, user, x, y, firemode, firemode.delay_charge);
+	charge.is_charged = false;
+	charge.has_charged = false;
+	charge.wake = GetNextProgressFrame(charge);
+	ScheduleWeaponCycle();
 	this->OnStartCharge(user, x, y, firemode);
 	return true; // keep charging
 }
@@ -605,8 +981,31 @@ func CancelCharge(object user, int x, int y, proplist firemode, bool callback)
 	{
 		if (callback) this->OnCancelCharge(effect.user, x, y, effect.firemode);
 
-		RemoveEffect(nil, nil, effect);
+		StopWeaponProcess("charge");
+		ScheduleWeaponCycle();
+	}
+}
+
+/**
+ Reports the progress of the charging process. This is called by the weapon cycle
+ at the progress thresholds, see {@link Library_Firearm#GetProgressGranularity}.@br
+ Calls {@link Library_Firearm#OnProgressCharge}.
+ @par charge The charging process.
+ @version 0.3.0
+*/
+func ProgressCharge(proplist charge)
+{
+	// Save the progress (i.e. the difference between the current percentage and during the last update)
+	charge.percentage = GetProcessProgress(charge);
+	charge.progress = charge.percentage - charge.percent_old;
+
+	if (charge.progress > 0)
+	{
+		this->OnProgressCharge(charge.user, charge.x, charge.y, charge.firemode, charge.percentage, charge.progress);
+		charge.percent_old = charge.percentage;
 	}
+
+	charge.wake = GetNextProgressFrame(charge);
 }
 
 /**
@@ -628,12 +1027,12 @@ func DoCharge(object user, int x, int y, proplist firemode)
 
 /**
  Checks if the weapon is currently charging.@br
- @return The charging effect.
- @version 0.2.0
+ @return The charging process, see {@link Library_Firearm#GetWeaponCycle}.
+ @version 0.3.0
 */
 func IsCharging()
 {
-	return GetEffect("IntChargeEffect", this);
+	return GetWeaponCycle().charge;
 }
 
 /**
@@ -648,7 +1047,7 @@ public func GetChargeProgress()
 	if (effect == nil)
 		return -1;
 	else
-		return effect.percent;
+		return GetProcessProgress(effect);
 }
 
 /**
@@ -688,7 +1087,7 @@ public func OnFinishCharge(object user, int x, int y, proplist firemode)
 }
 
 /**
- Callback: called each time during the charging process if the percentage of the charge progress changed. Does nothing by default.@br
+ Callback: called during the charging process when the charge progress reaches a threshold, see {@link Library_Firearm#GetProgressGranularity}. Does nothing by default.@br
  @par user The object that is using the weapon.
  @par x The x coordinate the user is aiming at. Relative to the user.
  @par y The y coordinate the user is aimint at. Relative to the user.
@@ -714,36 +1113,6 @@ public func OnCancelCharge(object user, int x, int y, proplist firemode)
 {
 }
 
-local IntChargeEffect = new Effect {
-	Construction = func(object user, proplist firemode)
-	{
-		this.user = user;
-		this.firemode = firemode;
-
-		this.percent_old = 0;
-		this.percentage = 0;
-		this.progress = 0;
-		this.is_charged = false;
-		this.has_charged = false;
-	},
-	Timer = func(int time)
-	{
-		// Increase progress percentage depending on the charging delay of the firemode
-		this.percentage = BoundBy(time * 100 / this.firemode.delay_charge, 0, 100);
-		// Save the progress (i.e. the difference between the current percentage and during the last update)
-		this.progress = this.percentage - this.percent_old;
-
-		// Check if the charging process is finished based on the charging delay of the firemode
-		if (time > this.firemode.delay_charge && !this.is_charged)
-		{
-			this.is_charged = true;
-			// Do not make subsequent calls of the timer function because every-frame-effects do hurt performance
-			this.Interval = 0;
-			// However, keep the effect, to track that this weapon is now charged
-		}
-	}
-};
-
 /*-- Firing --*/
 
 /**
@@ -752,7 +1121,8 @@ local IntChargeEffect = new Effect {
  */
 func IsReadyToFire()
 {
-	return !IsRecovering()
+	return !IsFiringBurst()
+	    && !IsRecovering()
 	    && !IsCoolingDown()
 	    && !IsWeaponLocked();
 }
@@ -781,6 +1151,17 @@ func DoFireCycle(object user, int x, int y, bool is_pressing_trigger)
 	if (is_pressing_trigger)
 		is_using = true;
 
+	if (firearm_beam)
+		AimBeam(user, x, y, GetFiremode());
+
+	// The remaining rounds of a burst follow the aim of the user
+	var burst = IsFiringBurst();
+	if (burst && burst.user == user)
+	{
+		burst.x = x;
+		burst.y = y;
+	}
+
 	if (IsReadyToFire())
 		if (!StartReload(user, x, y))
 			if (!StartCharge(user, x, y))
@@ -846,11 +1227,13 @@ func GetFireAngle(int x, int y, proplist firemode)
 
  The function does the following:@br
  - check ammo ({@link Library_Firearm#HasAmmo}) for the selected firemode (should be fine if this was called through {@link Library_Firearm#DoFireCycle)).@br
- - call {@link Library_Firearm#OnNoAmmo} if no ammunition was found.@br
- - call {@link Library_Firearm#FireSound}.@br
- - call {@link Library_Firearm#FireEffect}.@br
- - call {@link Library_Firearm#FireProjectiles}.@br
- - call {@link Library_Firearm#FireRecovery}.@br
+ - call {@link Library_Firearm#OnNoAmmo} if no ammunition was found, or if no shot could be paid for.@br
+ - in burst mode style, call {@link Library_Firearm#StartBurst} and skip the rest.@br
+ - get the amount of shots that are due ({@link Library_Firearm#GetShotsDue}).@br
+ - call {@link Library_Firearm#FireProjectiles}, or {@link Library_Firearm#FireBeam} in beam mode style.@br
+ - call {@link Library_Firearm#PlayFireSound}, once for all shots that were fired.@br
+ - call {@link Library_Firearm#FireEffect}, once for all shots that were fired.@br
+ - call {@link Library_Firearm#FireRecovery}, and add heat and spread for the shots that were fired.@br
  @par user The object that is using the weapon.
  @par x The x coordinate the user is aiming at. Relative to the user.
  @par y The y coordinate the user is aimint at. Relative to the user.
@@ -858,99 +1241,236 @@ func GetFireAngle(int x, int y, proplist firemode)
  */
 func Fire(object user, int x, int y)
 {
-	if (user == nil)
-		FatalError("The function expects a user that is not nil");
-
 	var firemode = GetFiremode();
 
-	if (firemode == nil)
-		FatalError(Format("Fire mode '%s' not supported", firemode));
+	// The fire mode was validated when it was compiled, see ValidateFiremode
+	if (g_shooter_checked)
+	{
+		if (user == nil)
+			FatalError("The function expects a user that is not nil");
+
+		ValidateFiremode(firemode);
+	}
 
+	var shots = 0;
 	if (HasAmmo(firemode))
 	{
+		if (firemode.mode == WEAPON_FM_Burst && firemode.burst > 0)
+		{
+			StartBurst(user, x, y, firemode);
+			return;
+		}
+
 		var angle = GetFireAngle(x, y, firemode);
 
-		FireSound(user, firemode);
-		FireEffect(user, angle, firemode);
-		FireProjectiles(user, angle, firemode);
-		FireRecovery(user, x, y, firemode);
-	}
-	else
-	{
-		this->OnNoAmmo(user, firemode);
+		var cycle = GetWeaponCycle();
+		cycle.state = WEAPON_State_Firing;
+
+		shots = GetShotsDue(firemode);
+
+		if (firemode.mode == WEAPON_FM_Beam)
+			shots = FireBeam(user, angle, firemode);
+		else
+			shots = FireProjectiles(user, angle, firemode, shots);
+
+		// Only shots that were paid for make a sound, and need recovery
+		if (shots > 0)
+		{
+			PlayFireSound(user, firemode);
+			FireEffect(user, angle, firemode);
+			FireRecovery(user, x, y, firemode);
+			AddBloom(firemode, shots);
+			AddHeat(user, firemode, shots);
+			return;
+		}
+		cycle.state = WEAPON_State_Idle;
 	}
+
+	StopBeam(user, firemode);
+	StopSustainedFireSound();
+	this->OnNoAmmo(user, firemode);
 }
 
 /**
  The actual firing function.@br@br
 
- The function will create new bullet objects, as many as the firemode defines. Since no actual ammo objects are taken or consumed, this should be handled in {@link Library_Firearm#HandleAmmoUsage}.@br
+ The function will create new bullet objects, as many as the firemode defines. Since no actual ammo objects are taken or consumed, this should be handled in {@link Library_Firearm#HandleAmmoUsage}.
+ The ammo is taken before the projectiles are created, and only the shots that ammo was available for are fired.@br
  Each time a single projectile is fired, {@link Library_Firearm#OnFireProjectile} is called.@br
  {@link Library_Firearm#GetProjectileAmount} and {@link Library_Firearm#GetSpread} can be used for custom behaviour.@br
  @par user The object that is using the weapon.
  @par angle The firing angle.
  @par firemode A proplist containing the fire mode information.
- @version 0.2.0
+ @par shots The amount of shots that are fired at once. The ammo for all of these is handled in a single
+            call of {@link Library_Firearm#TakeAmmoForShots}. Default is 1.
+ @par ammo_reserved If {@c true}, the ammo for the shots was already taken, see {@link Library_Firearm#StartBurst}.
+ @return int The amount of shots that were fired.
+ @version 0.3.0
 */
-func FireProjectiles(object user, int angle, proplist firemode)
+func FireProjectiles(object user, int angle, proplist firemode, int shots, bool ammo_reserved)
 {
-	if (user == nil)
+	if (g_shooter_checked)
 	{
-		FatalError("The function expects a user that is not nil");
+		if (user == nil)
+		{
+			FatalError("The function expects a user that is not nil");
+		}
+		if (firemode == nil)
+		{
+			FatalError("The function expects a fire mode that is not nil");
+		}
 	}
-	if (firemode == nil)
+	
+	// Callbacks get the fire mode, everything else reads from the flat copy
+	var compiled = GetCompiledFiremode(firemode);
+
+	var origin = GetFireOrigin(user, angle, compiled);
+	var x = origin[0];
+	var y = origin[1];
+
+	shots = Max(1, shots);
+
+	// take the ammo first, so that only shots that were paid for are fired
+	if (!ammo_reserved)
 	{
-		FatalError("The function expects a fire mode that is not nil");
+		shots = TakeAmmoForShots(compiled, shots);
+		if (shots <= 0)
+		{
+			return 0;
+		}
 	}
-	
-	var user_x = user->~GetWeaponX(this); if (user_x) user_x -= GetX();
-	var user_y = user->~GetWeaponY(this); if (user_y) user_y -= GetY();
 
-	var x = +Sin(angle, firemode.projectile_distance) + user_x;
-	var y = -Cos(angle, firemode.projectile_distance) + user_y + firemode.projectile_offset_y;
+	// all projectiles share the same deviation
+	var deviation = GetSpread(compiled);
 
-	// launch the single projectiles
-	for (var i = 0; i < Max(1, GetProjectileAmount(firemode)); i++)
+	// launch the single projectiles, every shot starts the pattern again
+	var amount = Max(1, GetProjectileAmount(compiled));
+	for (var i = 0; i < amount * shots; i++)
 	{
-		var projectile = CreateObject(firemode.projectile_id, x, y, user->GetController());
+		var projectile = CreateObject(compiled.projectile_id, x, y, user->GetController());
 
 		projectile->Shooter(user)
 		          ->Weapon(this)
-		          ->DamageAmount(firemode.damage)
-		          ->DamageType(firemode.damage_type)
-		          ->Velocity(SampleValue(firemode.projectile_speed))
-		          ->Range(SampleValue(firemode.projectile_range));
+		          ->DamageAmount(compiled.damage)
+		          ->DamageType(compiled.damage_type)
+		          ->Velocity(SampleFiremodeValue(compiled, "projectile_speed"))
+		          ->Range(SampleFiremodeValue(compiled, "projectile_range"));
 
 		this->OnFireProjectile(user, projectile, firemode);
-		projectile->Launch(angle, GetSpread(firemode));
+		projectile->Launch(angle, deviation, i % amount);
 	}
 
-	shot_counter[firemode.name]++;
-
-	HandleAmmoUsage(firemode);
+	shot_counter[compiled.slot] += shots;
+	return shots;
 }
 
 /**
- Gets the number of projectiles to be fired by a single shot.@br
+ Gets the amount of shots that are due now.@br
+ If the fire mode has a fire rate (see {@link Library_Firearm_Firemode#GetFireRate}), the time since the last shot
+ is accumulated with sub-frame precision. All shots that are due are fired at once, and the remainder carries over
+ to the next shot. The accumulator is reset when the weapon stops firing consecutive shots.
  @par firemode A proplist containing the fire mode information.
- @return By default, the return value is simple the projectile_number of the firemode. Can be overloaded for custom behaviour.
- @version 0.2.0
+ @return int The amount of shots, at least 1.
+ @version 0.3.0
 */
-func GetProjectileAmount(proplist firemode)
+func GetShotsDue(proplist firemode)
 {
-	return firemode.projectile_number;
-}
+	var rate = firemode.rate;
+	if (!rate || firemode.mode == WEAPON_FM_Beam)
+	{
+		return 1;
+	}
 
-/**
- Gets bullet deviations for a shot.@br
- @par firemode A proplist containing the fire mode information.
- @return By default, will compose the spread and projectile_spread values from the fire mode into an array and pass over to {@link NormalizeDeviations} or returns nil.
-*/
-func GetSpread(proplist firemode)
+	var cycle = GetWeaponCycle();
+	var accumulator = cycle.fire_rate;
+	var frame = FrameCounter();
+
+	if (accumulator == nil)
+	{
+		// The first shot is due immediately
+		accumulator = {
+			credit = WEAPON_FramesPerMinute, // int, shots * WEAPON_FramesPerMinute - the accumulated shots
+			frame = frame,                   // int, frame - the last shot was fired at this frame
+			delay = 0,                       // int, frames - the planned delay until the next shot
+		};
+		cycle.fire_rate = accumulator;
+	}
+	else
+	{
+		// Shots that were delayed by something else, such as reloading, are not caught up on
+		var elapsed = BoundBy(frame - accumulator.frame, 0, accumulator.delay + 1);
+		accumulator.credit += rate * elapsed;
+		accumulator.frame = frame;
+	}
+
+	var shots = Max(1, accumulator.credit / WEAPON_FramesPerMinute);
+	accumulator.credit = Max(0, accumulator.credit - shots * WEAPON_FramesPerMinute);
+	// The next shot is due as soon as a whole shot is accumulated
+	accumulator.delay = Max(1, (WEAPON_FramesPerMinute - accumulator.credit + rate - 1) / rate);
+	return shots;
+}
+
+/**
+ Gets the position where projectiles or beams start.@br
+ @par user The object that is using the weapon.
+ @par angle The firing angle.
+ @par firemode A proplist containing the fire mode information.
+ @return An array with the x and y coordinates, relative to the weapon.
+ @version 0.3.0
+*/
+func GetFireOrigin(object user, int angle, proplist firemode)
 {
+	var user_x = user->~GetWeaponX(this); if (user_x) user_x -= GetX();
+	var user_y = user->~GetWeaponY(this); if (user_y) user_y -= GetY();
+
+	var x = +Sin(angle, firemode.projectile_distance) + user_x;
+	var y = -Cos(angle, firemode.projectile_distance) + user_y + firemode.projectile_offset_y;
+	return [x, y];
+}
+
+/**
+ Gets the number of projectiles to be fired by a single shot.@br
+ @par firemode A proplist containing the fire mode information.
+ @return By default, the return value is simple the projectile_number of the firemode. Can be overloaded for custom behaviour.
+ @version 0.2.0
+*/
+func GetProjectileAmount(proplist firemode)
+{
+	return firemode.projectile_number;
+}
+
+/**
+ Gets bullet deviations for a shot.@br
+ @par firemode A proplist containing the fire mode information.
+ @return By default, will merge the spread and projectile_spread values from the fire mode with {@link Global#CompileDeviation} or returns nil.
+         For a compiled fire mode, the merged deviation is cached, see {@link Library_Firearm#GetCompiledFiremode}.
+         If the spread blooms, the current value of {@link Library_Firearm#GetBloom} is used instead of the spread angle.
+         A compiled fire mode merges the values once for every value of the bloom, and keeps the result.
+*/
+func GetSpread(proplist firemode)
+{
+	if (firemode.compiled_from != nil)
+	{
+		if (firemode.spread_limit == nil || firemode.spread == nil)
+		{
+			return firemode.spread_deviation;
+		}
+		var bloom = GetBloom();
+		var deviation = firemode.bloom_deviations[bloom];
+		if (deviation == nil)
+		{
+			deviation = MergeBloom(firemode, bloom);
+			firemode.bloom_deviations[bloom] = deviation;
+		}
+		return deviation;
+	}
 	if (firemode.spread || firemode.projectile_spread)
 	{
-		return NormalizeDeviations([firemode.spread, firemode.projectile_spread]);
+		if (firemode.spread && firemode.spread_limit != nil)
+		{
+			return MergeBloom(firemode, GetBloom());
+		}
+		return CompileDeviation([firemode.spread, firemode.projectile_spread], PROJECTILE_Launch_Precision);
 	}
 	else
 	{
@@ -958,9 +1478,78 @@ func GetSpread(proplist firemode)
 	}
 }
 
+/**
+ Merges a value of the blooming spread with the projectile spread of a fire mode, see {@link Library_Firearm#GetSpread}.
+ @par firemode A proplist containing the fire mode information.
+ @par bloom The spread angle, in the precision of the spread of the fire mode.
+ @return proplist The merged deviation.
+ @version 0.3.0
+*/
+func MergeBloom(proplist firemode, int bloom)
+{
+	var spread = Projectile_Deviation(bloom, firemode.spread.precision, firemode.spread.distribution);
+	return CompileDeviation([spread, firemode.projectile_spread], PROJECTILE_Launch_Precision);
+}
+
+/**
+ Gets the current spread from prolonged firing, if the spread of the fire mode blooms (see {@link Library_Firearm_Firemode#SetSpreadLimit}).@br
+ The spread is not simulated: the weapon stores the spread at the last shot and computes the current value from the time that passed since.
+ This is cheap, so a HUD can call it every frame, for example for the crosshair.
+ @return int The spread angle, in the precision of the spread of the fire mode.
+ @version 0.3.0
+*/
+public func GetBloom()
+{
+	var bloom = GetWeaponCycle().bloom;
+	if (bloom == nil)
+	{
+		return 0;
+	}
+	return GetBloomFraction(bloom) / WEAPON_FramesPerSecond;
+}
+
+/**
+ Gets the spread from prolonged firing in 1/36 units, so that the decay is exact.
+ @par bloom The bloom record of the weapon cycle.
+ @return int The spread angle, multiplied by {@c WEAPON_FramesPerSecond}.
+ @version 0.3.0
+*/
+func GetBloomFraction(proplist bloom)
+{
+	return Max(0, bloom.value - bloom.decay * (FrameCounter() - bloom.frame));
+}
+
+/**
+ Lets the spread bloom after shots, see {@link Library_Firearm_Firemode#SetSpreadLimit}.
+ @par firemode A proplist containing the fire mode information.
+ @par shots The amount of shots that were fired. Without shots, the spread does not bloom.
+ @version 0.3.0
+*/
+func AddBloom(proplist firemode, int shots)
+{
+	var spread = firemode.spread;
+	if (shots <= 0 || firemode.spread_limit == nil || spread == nil || GetType(spread.angle) != C4V_Int)
+	{
+		return;
+	}
+
+	var cycle = GetWeaponCycle();
+	var value = spread.angle * shots * WEAPON_FramesPerSecond;
+	if (cycle.bloom)
+	{
+		value += GetBloomFraction(cycle.bloom);
+	}
+	cycle.bloom = {
+		value = Min(value, firemode.spread_limit * WEAPON_FramesPerSecond), // int - the spread at the frame, multiplied by WEAPON_FramesPerSecond
+		frame = FrameCounter(),                   // int, frame - the spread was updated at this frame
+		decay = Max(0, firemode.spread_decay),    // int - per second, so this is the decay per frame in 1/36 units
+	};
+}
+
 /**
  Callback that happens each time an individual projectile is fired.
- @note By default this function is empty. You should create some kind of sound here.
+ @note By default this function is empty. You should create some kind of sound here,
+       preferably with {@link Library_Firearm#FirearmSound}.
  @par user The object that is using the weapon.
  @par firemode A proplist containing the fire mode information.
  */
@@ -968,6 +1557,101 @@ public func FireSound(object user, proplist firemode)
 {
 }
 
+/**
+ Callback for the sound of automatic fire modes while the use button is held.
+ @par user The object that is using the weapon.
+ @par firemode A proplist containing the fire mode information.
+ @return A string with the name of a looping sound. This sound is played instead of
+         {@link Library_Firearm#FireSound} as long as the weapon keeps firing.
+         The default is {@c nil}, so that {@link Library_Firearm#FireSound} is called for every shot.
+ @version 0.3.0
+ */
+public func SustainedFireSound(object user, proplist firemode)
+{
+	return nil;
+}
+
+/**
+ Plays the sound for a shot. This is called by {@link Library_Firearm#Fire}.@br
+ Automatic fire modes start the looping {@link Library_Firearm#SustainedFireSound} if there is one,
+ otherwise {@link Library_Firearm#FireSound} is called. The voice limit of the weapon
+ applies only to the sounds that {@link Library_Firearm#FireSound} plays with {@link Library_Firearm#FirearmSound}.
+ @par user The object that is using the weapon.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+ */
+func PlayFireSound(object user, proplist firemode)
+{
+	if (firemode.mode == WEAPON_FM_Auto)
+	{
+		var loop = this->SustainedFireSound(user, firemode);
+		if (loop)
+		{
+			if (loop != sustained_fire_sound)
+			{
+				StopSustainedFireSound();
+				sustained_fire_sound = loop;
+				Sound(sustained_fire_sound, false, nil, nil, +1);
+			}
+			return;
+		}
+	}
+
+	this->FireSound(user, firemode);
+}
+
+/**
+ Stops the looping {@link Library_Firearm#SustainedFireSound}, if it is playing.
+ @version 0.3.0
+ */
+func StopSustainedFireSound()
+{
+	if (sustained_fire_sound)
+	{
+		Sound(sustained_fire_sound, false, nil, nil, -1);
+	}
+	sustained_fire_sound = nil;
+}
+
+/**
+ The maximum amount of sounds that the weapon starts during {@c SOUND_Voice_Duration} frames.
+ @return int The voice limit, 3 by default. Overload this function for a custom limit.
+ @version 0.3.0
+ */
+public func GetSoundVoiceLimit()
+{
+	return 3;
+}
+
+/**
+ Plays a sound in the weapon, respecting the voice limit of the weapon
+ ({@link Library_Firearm#GetSoundVoiceLimit}) and the voice limits of the area ({@link Global#ThrottledSound}).
+ Sounds that would exceed the limits are skipped.
+ @par name The name of the sound, see Sound().
+ @par volume The volume, see Sound().
+ @par pitch The pitch, see Sound().
+ @return bool {@c true} if the sound was played.
+ @version 0.3.0
+ */
+public func FirearmSound(string name, int volume, int pitch)
+{
+	var frame = FrameCounter();
+
+	sound_voices = sound_voices ?? [];
+
+	// Forget voices that ended; the oldest voice is always first
+	while (GetLength(sound_voices) > 0 && frame - sound_voices[0] >= SOUND_Voice_Duration)
+	{
+		RemoveArrayIndex(sound_voices, 0);
+	}
+
+	if (GetLength(sound_voices) >= GetSoundVoiceLimit()) return false;
+	if (!ThrottledSound(name, volume, pitch)) return false;
+
+	PushBack(sound_voices, frame);
+	return true;
+}
+
 /**
  Callback that happens each time an individual projectile is fired.
  @note By default this function is empty. You should create graphical effects here.
@@ -989,6 +1673,20 @@ public func OnFireProjectile(object user, object projectile, proplist firemode)
 {
 }
 
+/**
+ Creates a muzzle flash.@br
+ The particle presets are created once and reused. The weapon has at most one light for the muzzle flash
+ ({@link MuzzleFlashLight}), which is re-triggered on every shot.
+ @par user The object that is using the weapon.
+ @par x The x coordinate of the muzzle. Relative to the user.
+ @par y The y coordinate of the muzzle. Relative to the user.
+ @par angle The angle the weapon is aimed at.
+ @par size The size of the flash, in pixels.
+ @par sparks If {@c true}, sparks fly from the muzzle.
+ @par light If {@c true}, the muzzle flash emits light.
+ @par color The color of the flash and light. Default is white.
+ @par particle The particle name. Default is "MuzzleFlash".
+*/
 func EffectMuzzleFlash(object user, int x, int y, int angle, int size, bool sparks, bool light, int color, string particle)
 {
 	if (user == nil)
@@ -1010,22 +1708,341 @@ func EffectMuzzleFlash(object user, int x, int y, int angle, int size, bool spar
 		b = GetRGBaValue(color, RGBA_BLUE);
 	}
 
-	user->CreateParticle(particle, x, y, 0, 0, 10, {Prototype = Particles_MuzzleFlash(), Size = size, Rotation = angle, R = r, G = g, B = b}, 1);
+	var presets = GetMuzzleFlashParticles();
+
+	// The particle properties are copied when the particle is created, so the preset can be modified
+	var flash = presets.flash;
+	flash.Size = size;
+	flash.Rotation = angle;
+	flash.R = r;
+	flash.G = g;
+	flash.B = b;
+
+	user->CreateParticle(particle, x, y, 0, 0, 10, flash, 1);
 
 	if (sparks)
 	{
 		var xdir = +Sin(angle, size * 2);
 		var ydir = -Cos(angle, size * 2);
 	
-		CreateParticle("StarFlash", x, y, PV_Random(xdir - size, xdir + size), PV_Random(ydir - size, ydir + size), PV_Random(20, 60), Particles_Glimmer(), size);
+		CreateParticle("StarFlash", x, y, PV_Random(xdir - size, xdir + size), PV_Random(ydir - size, ydir + size), PV_Random(20, 60), presets.sparks, size);
 	}
 
 	if (light)
 	{
-		user->CreateTemporaryLight(x, y)->LightRangeStart(3 * size)->SetLifetime(2)->Color(color)->Activate();
+		if (!muzzle_flash_light)
+		{
+			muzzle_flash_light = CreateObject(MuzzleFlashLight, 0, 0, NO_OWNER);
+		}
+		muzzle_flash_light->Flash(user->GetX() + x, user->GetY() + y, 3 * size, color);
+	}
+}
+
+/**
+ Gets the particle presets for {@link Library_Firearm#EffectMuzzleFlash}.
+ @return proplist A proplist with the properties flash and sparks.
+ @version 0.3.0
+*/
+func GetMuzzleFlashParticles()
+{
+	if (!muzzle_flash_particles)
+	{
+		muzzle_flash_particles = {
+			flash = { Prototype = Particles_MuzzleFlash() },
+			sparks = Particles_Glimmer(),
+		};
+	}
+	return muzzle_flash_particles;
+}
+
+/*-- Burst --*/
+
+/**
+ Starts firing a burst. This is called by {@link Library_Firearm#Fire} in burst mode style.@br@br
+
+ The function does the following:@br
+ - reserve the ammo for all rounds of the burst at once ({@link Library_Firearm#ReserveAmmoUsage}). If there is not enough ammo, the burst is shortened.@br
+ - fire the first round.@br
+ The weapon cycle fires the remaining rounds in intervals of the recovery delay of the fire mode ({@link Library_Firearm#FireBurstRound}).
+ The weapon recovers and cools down only after the last round.
+ @par user The object that is using the weapon.
+ @par x The x coordinate the user is aiming at. Relative to the user.
+ @par y The y coordinate the user is aiming at. Relative to the user.
+ @par firemode A proplist containing the fire mode information.
+ @return proplist The burst process, see {@link Library_Firearm#GetWeaponCycle}, or {@c nil} if there was no ammo.
+ @version 0.3.0
+*/
+func StartBurst(object user, int x, int y, proplist firemode)
+{
+	var reservation = ReserveAmmoUsage(firemode, firemode.burst);
+	var rounds = Min(firemode.burst, reservation.shots);
+	if (rounds < 1)
+	{
+		CommitAmmoUsage(firemode, reservation, 0);
+		this->OnNoAmmo(user, firemode);
+		return nil;
+	}
+
+	var burst = StartWeaponProcess("burst", WEAPON_State_Firing, user, x, y, firemode, rounds * Max(1, firemode.delay_recover));
+	burst.rounds = rounds;           // int - the burst consists of this many rounds
+	burst.fired = 0;                 // int - this many rounds were fired already
+	burst.reservation = reservation; // proplist - the ammo for the rounds, see ReserveAmmoUsage
+
+	FireBurstRound(burst);
+	return burst;
+}
+
+/**
+ Fires a single round of a burst. This is called by the weapon cycle, when the next round is due.@br
+ After the last round, the weapon starts recovering ({@link Library_Firearm#FireRecovery}).
+ @par burst The burst process.
+ @version 0.3.0
+*/
+func FireBurstRound(proplist burst)
+{
+	var user = burst.user;
+	var firemode = burst.firemode;
+
+	if (!user || RejectUse(user))
+	{
+		CancelBurst();
+		return;
+	}
+
+	var angle = GetFireAngle(burst.x, burst.y, firemode);
+
+	PlayFireSound(user, firemode);
+	FireEffect(user, angle, firemode);
+	FireProjectiles(user, angle, firemode, 1, true);
+
+	burst.fired += 1;
+	AddBloom(firemode, 1);
+	AddHeat(user, firemode, 1);
+
+	if (IsFiringBurst() != burst)
+	{
+		// overheated
+		return;
+	}
+
+	if (burst.fired < burst.rounds)
+	{
+		burst.wake = FrameCounter() + Max(1, firemode.delay_recover);
+	}
+	else
+	{
+		StopWeaponProcess("burst");
+		CommitAmmoUsage(firemode, burst.reservation, burst.fired);
+		FireRecovery(user, burst.x, burst.y, firemode);
+	}
+	ScheduleWeaponCycle();
+}
+
+/**
+ Stops a burst that is being fired. The ammo for the rounds that were not fired is given back
+ ({@link Library_Firearm#CommitAmmoUsage}), and the weapon starts cooling down ({@link Library_Firearm#CheckCooldown}).
+ @version 0.3.0
+*/
+public func CancelBurst()
+{
+	var burst = IsFiringBurst();
+	if (burst)
+	{
+		StopWeaponProcess("burst");
+		ScheduleWeaponCycle();
+
+		CommitAmmoUsage(burst.firemode, burst.reservation, burst.fired);
+		if (burst.user)
+		{
+			CheckCooldown(burst.user, burst.firemode);
+		}
+	}
+}
+
+/**
+ Checks if the weapon is currently firing a burst.@br
+ @return The burst process, see {@link Library_Firearm#GetWeaponCycle}.
+ @version 0.3.0
+*/
+public func IsFiringBurst()
+{
+	return GetWeaponCycle().burst;
+}
+
+/*-- Beam --*/
+
+/**
+ Fires a single damage tick of a beam fire mode.@br@br
+
+ The function will not create any projectiles. A single beam object is kept alive while the weapon is firing, 
+ and the beam damages the first target in its path in every tick.@br
+ The function does the following:@br
+ - call {@link Library_Firearm#TakeAmmoForShots}, so that ammo is used per tick.@br
+ - create the beam if necessary ({@link Library_Firearm#StartBeam}).@br
+ - call {@link Library_Firearm#BeamHitCheck}.@br
+ @par user The object that is using the weapon.
+ @par angle The firing angle.
+ @par firemode A proplist containing the fire mode information.
+ @return int 1 if the tick was fired, 0 if there was no ammo for it.
+ @version 0.3.0
+*/
+func FireBeam(object user, int angle, proplist firemode)
+{
+	if (TakeAmmoForShots(firemode, 1) <= 0)
+	{
+		StopBeam(user, firemode);
+		return 0;
+	}
+
+	var beam = StartBeam(user, angle, firemode);
+
+	BeamHitCheck(user, beam, firemode);
+
+	shot_counter[GetFiremodeSlot(firemode)]++;
+	return 1;
+}
+
+/**
+ Creates the beam if it does not exist yet, and points it at the firing angle.@br
+ Calls {@link Library_Firearm#OnStartBeam} when the beam is created.
+ @par user The object that is using the weapon.
+ @par angle The firing angle.
+ @par firemode A proplist containing the fire mode information.
+ @return object The beam.
+ @version 0.3.0
+*/
+func StartBeam(object user, int angle, proplist firemode)
+{
+	var origin = GetFireOrigin(user, angle, firemode);
+	var x = GetX() + origin[0] - user->GetX();
+	var y = GetY() + origin[1] - user->GetY();
+
+	if (firearm_beam)
+	{
+		firearm_beam->Attach(user, x, y)->SetRotation(angle);
+	}
+	else
+	{
+		firearm_beam = CreateObject(firemode.beam_id ?? LaserEffect, origin[0], origin[1], user->GetController());
+		firearm_beam->StopAtLandscape(true)
+		            ->SetRange(SampleFiremodeValue(GetCompiledFiremode(firemode), "projectile_range"))
+		            ->Attach(user, x, y)
+		            ->SetRotation(angle)
+		            ->Activate();
+
+		this->OnStartBeam(user, firearm_beam, firemode);
+	}
+	return firearm_beam;
+}
+
+/**
+ Updates the direction of the beam while the user aims. The beam recomputes its
+ end point only if this actually changes something.
+ @par user The object that is using the weapon.
+ @par x The x coordinate the user is aiming at. Relative to the user.
+ @par y The y coordinate the user is aiming at. Relative to the user.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+*/
+func AimBeam(object user, int x, int y, proplist firemode)
+{
+	if (firearm_beam && firemode.mode == WEAPON_FM_Beam)
+	{
+		StartBeam(user, GetFireAngle(x, y, firemode), firemode);
 	}
 }
 
+/**
+ Removes the beam, if there is one.@br
+ Calls {@link Library_Firearm#OnStopBeam}.
+ @par user The object that is using the weapon.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+*/
+func StopBeam(object user, proplist firemode)
+{
+	if (firearm_beam)
+	{
+		firearm_beam->RemoveObject();
+		this->OnStopBeam(user, firemode);
+	}
+	firearm_beam = nil;
+}
+
+/**
+ Checks whether the weapon is currently firing a beam.@br
+ @return The beam object.
+ @version 0.3.0
+*/
+public func GetBeam()
+{
+	return firearm_beam;
+}
+
+/**
+ Finds the first target along the beam and damages it.@br
+ Objects are hit if they are alive or return {@c true} for {@c IsProjectileTarget(object beam, object shooter)}.@br
+ Calls {@link Library_Firearm#OnBeamHit} before the target is damaged.
+ @par user The object that is using the weapon.
+ @par beam The beam object.
+ @par firemode A proplist containing the fire mode information.
+ @return object The target that was hit, or {@c nil}.
+ @version 0.3.0
+*/
+func BeamHitCheck(object user, object beam, proplist firemode)
+{
+	var end = beam->LaserEnd();
+
+	for (var target in beam->FindObjects(Find_OnLine(0, 0, end[0], end[1]),
+	                                     Find_NoContainer(),
+	                                     Find_Exclude(user),
+	                                     Sort_Distance(0, 0)))
+	{
+		if (target->~IsProjectileTarget(beam, user) || target->GetOCF() & OCF_Alive)
+		{
+			this->OnBeamHit(user, target, firemode);
+			if (target)
+			{
+				beam->WeaponDamageShooter(target, firemode.damage, firemode.damage_type, nil, false, GetID());
+			}
+			return target;
+		}
+	}
+	return nil;
+}
+
+/**
+ Callback: the weapon starts firing a beam. Does nothing by default.
+ @par user The object that is using the weapon.
+ @par beam The beam object.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+ */
+public func OnStartBeam(object user, object beam, proplist firemode)
+{
+}
+
+/**
+ Callback: the weapon stops firing a beam. Does nothing by default.
+ @par user The object that is using the weapon. Can be {@c nil} if the weapon is removed.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+ */
+public func OnStopBeam(object user, proplist firemode)
+{
+}
+
+/**
+ Callback: the beam hits a target, before the target is damaged. Does nothing by default.
+ @par user The object that is using the weapon.
+ @par target The object that was hit.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+ */
+public func OnBeamHit(object user, object target, proplist firemode)
+{
+}
+
 /*-- Recovering --*/
 
 /**
@@ -1033,7 +2050,7 @@ func EffectMuzzleFlash(object user, int x, int y, int angle, int size, bool spar
 
  This function does the following:
  - check if recovering is needed ({@link Library_Firearm#NeedsRecovery}).@br
- - if yes, create a recovery effect.@br
+ - if yes, start recovering for the recovery delay of the fire mode, or until the next shot is due if the fire mode has a fire rate.@br
  @par user The object that is using the weapon.
  @par x The x coordinate the user is aiming at. Relative to the user.
  @par y The y coordinate the user is aimint at. Relative to the user.
@@ -1043,12 +2060,16 @@ func EffectMuzzleFlash(object user, int x, int y, int angle, int size, bool spar
 func FireRecovery(object user, int x, int y, proplist firemode)
 {
 	var delay;
-	if (NeedsRecovery(user, firemode))
-		delay = firemode.delay_recover;
-	else
+	var cycle = GetWeaponCycle();
+	if (!NeedsRecovery(user, firemode))
 		delay = 1;
+	else if (firemode.rate && cycle.fire_rate)
+		delay = cycle.fire_rate.delay;
+	else
+		delay = firemode.delay_recover;
 
-	CreateEffect(IntRecoveryEffect, 1, delay, user, x, y, firemode);
+	StartWeaponProcess("recovery", WEAPON_State_Recovering, user, x, y, firemode, delay);
+	ScheduleWeaponCycle();
 }
 
 /**
@@ -1069,10 +2090,8 @@ public func NeedsRecovery(object user, proplist firemode)
 */
 func CancelRecovery()
 {
-	var effect = IsRecovering();
-	
-	if (effect != nil)
-		RemoveEffect(nil, nil, effect);
+	StopWeaponProcess("recovery");
+	ScheduleWeaponCycle();
 }
 
 /**
@@ -1085,8 +2104,7 @@ func GetRecoveryProgress()
 	var recovery = IsRecovering();
 	if (recovery)
 	{
-		var progress = BoundBy(recovery.Time, 0, recovery.Interval);
-		return progress * 100 / recovery.Interval;
+		return GetProcessProgress(recovery);
 	}
 	else
 	{
@@ -1096,19 +2114,18 @@ func GetRecoveryProgress()
 
 /**
  Checks if the weapon is currently recovering.@br
- @return The recovering effect.
- @version 0.2.0
+ @return The recovering process, see {@link Library_Firearm#GetWeaponCycle}.
+ @version 0.3.0
 */
 func IsRecovering()
 {
-	return GetEffect("IntRecoveryEffect", this);
+	return GetWeaponCycle().recovery;
 }
 
 /**
  This function is called after the recovery process is done.@br
- It calls {@link Library_Firearm#OnRecovery}.@br
- On a fire mode with burst set, it will go through {@link Library_Firearm#CancelRecovery} and {@link Library_Firearm#DoFireCycle} until the appropriate amounts of shot is fired.@br
- Otherwise {@link Library_Firearm#CheckCooldown} is called.@br
+ It calls {@link Library_Firearm#OnRecovery}, then {@link Library_Firearm#CheckCooldown}.@br
+ Bursts are fired by {@link Library_Firearm#StartBurst}, so that the weapon recovers only after the last round of a burst.@br
  @par user The object that is using the weapon.
  @par x The x coordinate the user is aiming at. Relative to the user.
  @par y The y coordinate the user is aimint at. Relative to the user.
@@ -1121,29 +2138,6 @@ func DoRecovery(object user, int x, int y, proplist firemode)
 
 	this->OnRecovery(user, firemode);
 
-	if (firemode.burst)
-	{
-		if (firemode.mode != WEAPON_FM_Burst)
-		{
-			FatalError(Format("This fire mode has a burst value of %d, but the mode is not burst mode WEAPN_FM_Burst (value: %d)", firemode.burst, firemode.mode));
-		}
-
-		if (shot_counter[firemode.name] >= firemode.burst)
-		{
-			shot_counter[firemode.name] = 0;
-		}
-		else
-		{
-			if (!is_using)
-			{
-				CancelRecovery();
-				DoFireCycle(user, x, y, false);
-			}
-
-			return; // prevent cooldown
-		}
-	}
-
 	CheckCooldown(user, firemode);
 }
 
@@ -1157,26 +2151,12 @@ public func OnRecovery(object user, proplist firemode)
 {
 }
 
-local IntRecoveryEffect = new Effect {
-	Construction = func(object user, int x, int y, proplist firemode)
-	{
-		this.user = user;
-		this.x = x;
-		this.y = y;
-		this.firemode = firemode;
-	},
-	Timer = func()
-	{
-		this.Target->DoRecovery(this.user, this.x, this.y, this.firemode);
-		return FX_Execute_Kill;
-	}
-};
-
 /*-- Cooldown --*/
 
 /**
  Called by {@link Library_Firearm#DoRecovery}.@br
  Will call {@link Library_Firearm#StartCooldown} if the weapon has still ammunition left and is not an automatic weapon.@br
+ Stops the beam of a beam fire mode if the weapon is not being used anymore.@br
  @par user The object that is using the weapon.
  @par firemode A proplist containing the fire mode information.
 */
@@ -1185,8 +2165,15 @@ func CheckCooldown(object user, proplist firemode)
 	if (!HasAmmo(firemode) || RejectUse(user))
 		CancelUsing();
 
-	if ((firemode.mode != WEAPON_FM_Auto) || (firemode.mode == WEAPON_FM_Auto && !is_using))
+	if (!FiresContinuously(firemode) || !is_using)
+	{
+		var cycle = GetWeaponCycle();
+		cycle.fire_rate = nil;
+
+		StopBeam(user, firemode);
+		StopSustainedFireSound();
 		StartCooldown(user, firemode);
+	}
 }
 
 /**
@@ -1202,6 +2189,12 @@ func CheckCooldown(object user, proplist firemode)
 */
 func StartCooldown(object user, proplist firemode)
 {
+	// The weapon is cooling down from overheating already
+	if (IsCoolingDown())
+	{
+		return;
+	}
+
 	if (firemode.delay_cooldown < 1 || !NeedsCooldown(user, firemode))
 	{
 		this->OnSkipCooldown(user, firemode);
@@ -1212,7 +2205,8 @@ func StartCooldown(object user, proplist firemode)
 
 	if (effect == nil)
 	{
-		CreateEffect(IntCooldownEffect, 1, firemode.delay_cooldown, user, firemode);
+		StartWeaponProcess("cooldown", WEAPON_State_Cooling, user, nil, nil, firemode, firemode.delay_cooldown);
+		ScheduleWeaponCycle();
 		this->OnStartCooldown(user, firemode);
 	}
 }
@@ -1236,8 +2230,7 @@ func GetCooldownProgress()
 	var cooldown = IsCoolingDown();
 	if (cooldown)
 	{
-		var progress = BoundBy(cooldown.Time, 0, cooldown.Interval);
-		return progress * 100 / cooldown.Interval;
+		return GetProcessProgress(cooldown);
 	}
 	else
 	{
@@ -1247,12 +2240,12 @@ func GetCooldownProgress()
 
 /**
  Checks if the weapon is currently cooling down.@br
- @return The cooldown effect.
- @version 0.2.0
+ @return The cooldown process, see {@link Library_Firearm#GetWeaponCycle}.
+ @version 0.3.0
 */
 func IsCoolingDown()
 {
-	return GetEffect("IntCooldownEffect", this);
+	return GetWeaponCycle().cooldown;
 }
 
 /**
@@ -1297,18 +2290,100 @@ public func OnSkipCooldown(object user, proplist firemode)
 {
 }
 
-local IntCooldownEffect = new Effect {
-	Construction = func(object user, proplist firemode)
+/*-- Heat --*/
+
+/**
+ Gets the current heat of the weapon, see {@link Library_Firearm_Firemode#SetHeatPerShot}.@br
+ The heat is not simulated: the weapon stores the heat at the last shot and computes the current heat from the time that passed since.
+ @return int The heat.
+ @version 0.3.0
+*/
+public func GetHeat()
+{
+	var heat = GetWeaponCycle().heat;
+	if (heat == nil)
 	{
-		this.user = user;
-		this.firemode = firemode;
-	},
-	Timer = func()
+		return 0;
+	}
+	return GetHeatFraction(heat) / WEAPON_FramesPerSecond;
+}
+
+/**
+ Gets the heat of the weapon in 1/36 units, so that the decay is exact.
+ @par heat The heat record of the weapon cycle.
+ @return int The heat, multiplied by {@c WEAPON_FramesPerSecond}.
+ @version 0.3.0
+*/
+func GetHeatFraction(proplist heat)
+{
+	return Max(0, heat.value - heat.decay * (FrameCounter() - heat.frame));
+}
+
+/**
+ Adds the heat of shots to the weapon. If the heat reaches the limit of the fire mode, the weapon overheats:
+ it cannot fire until the heat has decayed completely, or for the cooldown delay of the fire mode if the heat does not decay. This uses the cooldown process, so {@link Library_Firearm#OnStartCooldown}
+ and {@link Library_Firearm#OnFinishCooldown} are called, and the end of the cooldown is scheduled at the frame where the heat reaches 0.
+ @par user The object that is using the weapon.
+ @par firemode A proplist containing the fire mode information.
+ @par shots The amount of shots that were fired. Without shots, no heat is added.
+ @version 0.3.0
+*/
+func AddHeat(object user, proplist firemode, int shots)
+{
+	if (shots <= 0 || firemode.heat_per_shot < 1)
 	{
-		this.Target->DoCooldown(this.user, this.firemode);
-		return FX_Execute_Kill;
+		return;
 	}
-};
+
+	var cycle = GetWeaponCycle();
+	var value = firemode.heat_per_shot * shots * WEAPON_FramesPerSecond;
+	if (cycle.heat)
+	{
+		value += GetHeatFraction(cycle.heat);
+	}
+	cycle.heat = {
+		value = value,                            // int - the heat at the frame, multiplied by WEAPON_FramesPerSecond
+		frame = FrameCounter(),                   // int, frame - the heat was updated at this frame
+		decay = Max(0, firemode.heat_decay),      // int - per second, so this is the decay per frame in 1/36 units
+	};
+
+	if (value >= firemode.heat_limit * WEAPON_FramesPerSecond && !IsCoolingDown())
+	{
+		Overheat(user, firemode);
+	}
+}
+
+/**
+ Stops firing and lets the weapon cool down until the heat has decayed completely.
+ @par user The object that is using the weapon.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+*/
+func Overheat(object user, proplist firemode)
+{
+	var heat = GetWeaponCycle().heat;
+	var duration;
+	if (heat.decay > 0)
+	{
+		duration = (heat.value + heat.decay - 1) / heat.decay;
+	}
+	else
+	{
+		// The heat stays until the lockout ends, see ExecuteWeaponCycle
+		duration = Max(1, firemode.delay_cooldown);
+	}
+
+	// Start cooling down first, so that cancelling the burst does not start a regular cooldown
+	var cooldown = StartWeaponProcess("cooldown", WEAPON_State_Cooling, user, nil, nil, firemode, duration);
+	cooldown.overheat = true;
+
+	CancelBurst();
+	StopBeam(user, firemode);
+	StopSustainedFireSound();
+
+	ScheduleWeaponCycle();
+	this->OnStartCooldown(user, firemode);
+}
 
 /*-- Reloading --*/
 
@@ -1332,13 +2407,21 @@ func StartReload(object user, int x, int y, bool forced)
 {
 	var firemode = GetFiremode();
 
-	if (firemode == nil)
+	if (g_shooter_checked && firemode == nil)
 	{
 		FatalError(Format("Fire mode '%s' not supported", firemode));
 	}
 
 	if ((!is_using && !forced) || !NeedsReload(user, firemode)) return false;
 
+	// An interrupted incremental reload is not started again while the weapon can still fire
+	var cycle = GetWeaponCycle();
+	if (cycle.reload_interrupted && !forced && HasAmmo(firemode))
+	{
+		return false;
+	}
+	cycle.reload_interrupted = false;
+
 	var effect = IsReloading();
 
 	if (effect != nil)
@@ -1365,7 +2448,12 @@ func StartReload(object user, int x, int y, bool forced)
 
 	if (CanReload(user, firemode))
 	{
-		CreateEffect(IntReloadEffect, 1, 1, user, x, y, firemode);
+		var reload = StartWeaponProcess("reload", WEAPON_State_Reloading, user, x, y, firemode, firemode.delay_reload);
+		reload.is_reloaded = false;
+		reload.step = firemode.reload_step; // int - rounds per step, nil or 0 if everything is loaded at once
+		reload.rounds = 0;                  // int - rounds that were loaded so far
+		reload.wake = GetNextReloadProgressFrame(reload);
+		ScheduleWeaponCycle();
 		this->OnStartReload(user, x, y, firemode);
 	}
 
@@ -1393,12 +2481,41 @@ func CancelReload(object user, int x, int y, proplist firemode, bool requested_b
 	{
 		this->OnCancelReload(effect.user, x, y, effect.firemode, requested_by_user);
 
-		if (!auto_reload) RemoveEffect(nil, nil, effect);
+		if (!auto_reload)
+		{
+			StopWeaponProcess("reload");
+			ScheduleWeaponCycle();
+		}
+	}
+}
+
+/**
+ Interrupts an incremental reload, see {@link Library_Firearm_Firemode#SetReloadStep}, so that the weapon can fire.
+ This happens only if at least one step was loaded. Called when the user pulls the trigger.
+ {@link Library_Firearm#StartReload} does not start reloading again until the weapon runs out of ammo, or the reload is forced.@br
+ Calls {@link Library_Firearm#OnCancelReload}.
+ @par user The object that is using the weapon.
+ @par x The x coordinate the user is aiming at. Relative to the user.
+ @par y The y coordinate the user is aimint at. Relative to the user.
+ @return {@c true} if reloading was interrupted.
+ @version 0.3.0
+*/
+func InterruptReload(object user, int x, int y)
+{
+	var reload = IsReloading();
+	if (reload && reload.step > 0 && reload.rounds > 0)
+	{
+		this->OnCancelReload(reload.user, x, y, reload.firemode, false);
+		StopWeaponProcess("reload");
+		GetWeaponCycle().reload_interrupted = true;
+		ScheduleWeaponCycle();
+		return true;
 	}
+	return false;
 }
 
 /**
- Called by the reloading effect if reloading should be finished. If it returns false, the reloading effect will linger and assumes that something else needs to be done. If it returns true, the reloading effect will end.@br@br
+ Called by the weapon cycle if reloading should be finished. If it returns false, the reloading process will linger and assumes that something else needs to be done. If it returns true, the reloading process will end.@br@br
 
  Calls {@link Library_Firearm#OnFinishReload}.@br
  @par user The object that is using the weapon.
@@ -1415,12 +2532,89 @@ func DoReload(object user, int x, int y, proplist firemode)
 
 /**
  Checks if the weapon is currently reloading.@br
- @return The reloading effect.
- @version 0.2.0
+ @return The reloading process, see {@link Library_Firearm#GetWeaponCycle}.
+ @version 0.3.0
 */
 func IsReloading()
 {
-	return GetEffect("IntReloadEffect", this);
+	return GetWeaponCycle().reload;
+}
+
+/**
+ Advances the reloading process. This is called by the weapon cycle at the progress thresholds
+ (see {@link Library_Firearm#GetProgressGranularity}), and when the reloading delay of the fire mode has passed.@br
+ Calls {@link Library_Firearm#OnProgressReload} and {@link Library_Firearm#DoReload}.
+ @par reload The reloading process.
+ @version 0.3.0
+*/
+func ProgressReload(proplist reload)
+{
+	// Check if the reloading process is finished based on the reloading delay of the firemode
+	if (FrameCounter() - reload.start > reload.duration)
+	{
+		// Incremental reload: load a step, then start over with the next step in the same process
+		if (reload.step > 0)
+		{
+			reload.rounds += reload.step;
+			this->OnReloadStep(reload.user, reload.x, reload.y, reload.firemode, reload.step);
+
+			if (IsReloading() != reload)
+			{
+				return;
+			}
+
+			if (!this->IsReloadComplete(reload.user, reload.firemode) && this->CanReload(reload.user, reload.firemode))
+			{
+				reload.start = FrameCounter();
+				reload.percent_old = 0;
+				reload.percentage = 0;
+				reload.progress = 0;
+				reload.wake = GetNextReloadProgressFrame(reload);
+				return;
+			}
+		}
+
+		reload.is_reloaded = true;
+		reload.wake = nil;
+
+		// Do the reload if anything is necessary and end the process if successful
+		if (DoReload(reload.user, reload.x, reload.y, reload.firemode) && IsReloading() == reload)
+		{
+			StopWeaponProcess("reload");
+		}
+		return;
+	}
+
+	// Save the progress (i.e. the difference between the current percentage and during the last update)
+	reload.percentage = GetProcessProgress(reload);
+	reload.progress = reload.percentage - reload.percent_old;
+
+	// Do a progress update if necessary
+	if (reload.progress > 0)
+	{
+		this->OnProgressReload(reload.user, reload.x, reload.y, reload.firemode, reload.percentage, reload.progress);
+		reload.percent_old = reload.percentage;
+	}
+
+	reload.wake = GetNextReloadProgressFrame(reload);
+}
+
+/**
+ Gets the next frame where the reloading process has to be advanced.
+ @par reload The reloading process.
+ @return int The frame where the progress reaches the next threshold, or the frame
+         where reloading is finished, whichever comes first.
+ @version 0.3.0
+*/
+func GetNextReloadProgressFrame(proplist reload)
+{
+	var finish = reload.start + reload.duration + 1;
+	var wake = GetNextProgressFrame(reload);
+	if (wake == nil || wake > finish)
+	{
+		return finish;
+	}
+	return wake;
 }
 
 /**
@@ -1474,6 +2668,40 @@ public func OnStartReload(object user, int x, int y, proplist firemode)
 {
 }
 
+/**
+ Condition if an incremental reload is complete, that is if the magazine is full, see {@link Library_Firearm_Firemode#SetReloadStep}.@br
+ This is not the opposite of {@link Library_Firearm#NeedsReload}: a weapon may need no reload, because it can fire,
+ while its magazine is not full yet.
+ @par user The object that is using the weapon.
+ @par firemode A proplist containing the fire mode information.
+ @return {@c true} if the ammo of the fire mode reached its {@c ammo_load}. Without ammo logic, or without
+         an {@c ammo_load}, the magazine capacity is unknown, and the reload is complete after the first step.
+         Overload this function for a custom condition.
+ @version 0.3.0
+ */
+public func IsReloadComplete(object user, proplist firemode)
+{
+	if (!Setting_WithAmmoLogic() || firemode.ammo_load == nil)
+	{
+		return true;
+	}
+	return this->GetAmmo(firemode) >= firemode.ammo_load;
+}
+
+/**
+ Callback: the weapon loaded a step of an incremental reload, see {@link Library_Firearm_Firemode#SetReloadStep}. Does nothing by default.@br
+ {@link Library_Firearm#OnFinishReload} is called after the last step.
+ @par user The object that is using the weapon.
+ @par x The x coordinate the user is aiming at. Relative to the user.
+ @par y The y coordinate the user is aimint at. Relative to the user.
+ @par firemode A proplist containing the fire mode information.
+ @par rounds The amount of rounds that were loaded in this step.
+ @version 0.3.0
+ */
+public func OnReloadStep(object user, int x, int y, proplist firemode, int rounds)
+{
+}
+
 /**
  Callback: the weapon has successfully reloaded. Does nothing by default.@br
  @par user The object that is using the weapon.
@@ -1487,7 +2715,7 @@ public func OnFinishReload(object user, int x, int y, proplist firemode)
 }
 
 /**
- Callback: called each time during the reloading process if the percentage of the reload progress changed. Does nothing by default.@br
+ Callback: called during the reloading process when the reload progress reaches a threshold, see {@link Library_Firearm#GetProgressGranularity}. Does nothing by default.@br
  @par user The object that is using the weapon.
  @par x The x coordinate the user is aiming at. Relative to the user.
  @par y The y coordinate the user is aimint at. Relative to the user.
@@ -1513,45 +2741,6 @@ public func OnCancelReload(object user, int x, int y, proplist firemode, bool re
 {
 }
 
-local IntReloadEffect = new Effect {
-	Construction = func(object user, int x, int y, proplist firemode)
-	{
-		this.user = user;
-		this.x = x; // x and y will be updated by StartReload
-		this.y = y;
-		this.firemode = firemode;
-
-		this.percent_old = 0;
-		this.percentage = 0;
-		this.progress = 0;
-		this.is_reloaded = false;
-	},
-	Timer = func(int time)
-	{
-		// Increase progress percentage depending on the reloading delay of the firemode
-		this.percentage = BoundBy(time * 100 / this.firemode.delay_reload, 0, 100);
-		// Save the progress (i.e. the difference between the current percentage and during the last update)
-		this.progress = this.percentage - this.percent_old;
-
-		// Check if the reloading process is finished based on the reloading delay of the firemode
-		if (time > this.firemode.delay_reload && !this.is_reloaded)
-		{
-			this.is_reloaded = true;
-
-			// Do the reload if anything is necessary and end the effect if successful
-			if (this.Target->DoReload(this.user, this.x, this.y, this.firemode))
-				return FX_Execute_Kill;
-		}
-
-		// Do a progress update if necessary
-		if (this.progress > 0)
-		{
-			this.Target->OnProgressReload(this.user, this.x, this.y, this.firemode, this.percentage, this.progress);
-			this.percent_old = this.progress;
-		}
-	}
-};
-
 /*-- Firemodes --*/
 
 /**
@@ -1584,6 +2773,7 @@ public func MakeFiremodeWritable(int number)
 	}
 
 	fire_modes[number] = { Prototype = fire_modes[number] };
+	InvalidateAvailableFiremodes();
 }
 
 /**
@@ -1601,8 +2791,9 @@ public func SetFiremode(int number, bool force)
 		return;
 	}
 
-	if (force || CanChangeFiremode() || IsFiremodeAvailable(GetFiremode(number)))
+	if (force || CanChangeFiremode() || GetIndexOf(GetAvailableFiremodes(), GetFiremode(number)) != -1)
 	{
+		ValidateFiremode(GetFiremode(number));
 		selected_firemode = number;
 		return true;
 	}
@@ -1621,7 +2812,15 @@ public func SetFiremode(int number, bool force)
  */
 public func GetFiremode(int number)
 {
-	number = number ?? selected_firemode;
+	if (number == nil)
+	{
+		// Selecting the fire mode checks the range already
+		if (!g_shooter_checked)
+		{
+			return fire_modes[selected_firemode];
+		}
+		number = selected_firemode;
+	}
 	if (number < 0 || number >= GetLength(fire_modes))
 	{
 		FatalError(Format("The fire mode (%v) is out of range of all configured fire modes (%v)", number, GetLength(fire_modes)));
@@ -1630,6 +2829,216 @@ public func GetFiremode(int number)
 	return fire_modes[number];
 }
 
+/**
+ Gets a flat, read-only copy of a fire mode.@br
+ Reading a property of a fire mode goes through its prototypes, usually the fire mode, fire_mode_default, and {@link Library_Firearm_Firemode}.
+ The copy has all properties of the fire mode and its prototypes, and only {@link Library_Firearm_Firemode} as prototype, so that the getters still work.@br
+ The copy is cached by the weapon and compiled again only if the version of the fire mode changed, see {@link Library_Firearm_Firemode#GetVersion}.
+ The copy also has the slot of the fire mode, see {@link Library_Firearm#GetFiremodeSlot},
+ and sample tables for the properties that are ranges, see {@link Library_Firearm#SampleFiremodeValue}.
+ The spread and projectile spread are merged into a single deviation, see {@link Library_Firearm#GetSpread}.
+ Do not modify the copy, use the setters on the fire mode instead.
+ @par firemode A proplist containing the fire mode information.
+ @return proplist The copy of the fire mode. If {@c firemode} is a copy already, it is returned as it is.
+ @version 0.3.0
+*/
+public func GetCompiledFiremode(proplist firemode)
+{
+	if (firemode == nil || firemode.compiled_from != nil)
+	{
+		return firemode;
+	}
+
+	compiled_firemodes = compiled_firemodes ?? [];
+
+	var version = firemode->GetVersion();
+	var compiled = nil;
+	for (var copy in compiled_firemodes)
+	{
+		if (copy.compiled_from == firemode)
+		{
+			if (copy.version == version)
+			{
+				return copy;
+			}
+			compiled = copy;
+			break;
+		}
+	}
+
+	if (compiled == nil)
+	{
+		compiled = { slot = GetLength(compiled_firemodes) };
+		PushBack(compiled_firemodes, compiled);
+	}
+
+	// Copy the properties, the nearest prototype wins
+	for (var mode = firemode; mode != nil && mode != Library_Firearm_Firemode; mode = GetPrototype(mode))
+	{
+		for (var property in GetProperties(mode))
+		{
+			if (property != "Prototype" && property != "slot")
+			{
+				compiled[property] = firemode[property];
+			}
+		}
+	}
+	compiled.Prototype = Library_Firearm_Firemode;
+	compiled.compiled_from = firemode;
+	compiled.version = version;
+	ValidateFiremode(compiled);
+	CreateSampleTables(compiled);
+	compiled.spread_deviation = CompileDeviation([compiled.spread, compiled.projectile_spread], PROJECTILE_Launch_Precision);
+	compiled.bloom_deviations = []; // array - the merged deviation for each value of a blooming spread, see GetSpread
+	return compiled;
+}
+
+/**
+ Validates a fire mode. This happens whenever a fire mode is added, selected, or compiled
+ after it was changed, see {@link Library_Firearm#GetCompiledFiremode}, so that the functions
+ that run on every shot do not have to check the fire mode again.
+ The projectile values are checked here, because the projectile does not check its settings
+ with the unchecked validation profile.
+ With the checked validation profile, see {@link Global#SetShooterChecked}, this happens on every shot, too.@br
+ Make sure to call this via _inherited(); if you overload it.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+ */
+func ValidateFiremode(proplist firemode)
+{
+	if (firemode == nil)
+	{
+		FatalError(Format("Fire mode '%s' not supported", firemode));
+	}
+
+	if (firemode.burst && firemode.mode != WEAPON_FM_Burst)
+	{
+		FatalError(Format("This fire mode has a burst value of %d, but the mode is not burst mode WEAPON_FM_Burst (value: %d)", firemode.burst, firemode.mode));
+	}
+
+	if (firemode.mode != WEAPON_FM_Beam && GetType(firemode.projectile_id) != C4V_Def)
+	{
+		FatalError(Format("The fire mode needs a projectile definition, got %v", firemode.projectile_id));
+	}
+
+	if (firemode.projectile_distance < 0)
+	{
+		FatalError(Format("The projectile distance must not be negative, got %d", firemode.projectile_distance));
+	}
+
+	for (var property in this->GetSampledFiremodeProperties())
+	{
+		ValidateFiremodeRange(firemode, property);
+	}
+	for (var property in ["projectile_speed", "projectile_range"])
+	{
+		var value = firemode[property];
+		if (GetType(value) == C4V_Array)
+		{
+			value = value[0];
+		}
+		if (value < 0)
+		{
+			FatalError(Format("The fire mode property %s must not be negative, got %v", property, firemode[property]));
+		}
+	}
+
+	ValidateFiremodeDeviation(firemode, "spread");
+	ValidateFiremodeDeviation(firemode, "projectile_spread");
+
+	_inherited(firemode, ...);
+}
+
+/**
+ Validates a fire mode property that can be a range, see {@link Library_Firearm#SampleFiremodeValue}.
+ The value is an {@c int}, or an array {@c [min, max]} or {@c [min, max, step]}.
+ @par firemode A proplist containing the fire mode information.
+ @par property The name of the property.
+ @version 0.3.0
+ */
+func ValidateFiremodeRange(proplist firemode, string property)
+{
+	var value = firemode[property];
+	if (GetType(value) == C4V_Nil || GetType(value) == C4V_Int)
+	{
+		return;
+	}
+	if (GetType(value) != C4V_Array || GetLength(value) < 2 || GetLength(value) > 3)
+	{
+		FatalError(Format("The fire mode property %s must be an int or a range [min, max, step], got %v", property, value));
+	}
+	if (value[1] < value[0])
+	{
+		FatalError(Format("The fire mode property %s has a maximum that is less than its minimum: %v", property, value));
+	}
+	if (GetLength(value) == 3 && value[2] < 1)
+	{
+		FatalError(Format("The fire mode property %s has a step that is not positive: %v", property, value));
+	}
+}
+
+/**
+ Validates a fire mode property that is a deviation, see {@link Global#Projectile_Deviation}.
+ @par firemode A proplist containing the fire mode information.
+ @par property The name of the property.
+ @version 0.3.0
+ */
+func ValidateFiremodeDeviation(proplist firemode, string property)
+{
+	var deviation = firemode[property];
+	if (deviation == nil)
+	{
+		return;
+	}
+	if (GetType(deviation) != C4V_PropList)
+	{
+		FatalError(Format("The fire mode property %s must be a deviation, see Projectile_Deviation(), got %v", property, deviation));
+	}
+	if (GetType(deviation.angle) != C4V_Int && GetType(deviation.angle) != C4V_Array)
+	{
+		FatalError(Format("The deviation %s needs an angle or an array of angles, got %v", property, deviation.angle));
+	}
+	if (deviation.precision != nil && deviation.precision < 1)
+	{
+		FatalError(Format("The deviation %s needs a positive precision, got %v", property, deviation.precision));
+	}
+}
+
+/**
+ Gets the slot of a fire mode.@br
+ Each fire mode that the weapon uses gets a dense integer index, so that counters per fire mode can be stored in arrays.
+ The slot of a fire mode never changes while the weapon exists.
+ @par firemode A proplist containing the fire mode information, or the name of a fire mode.
+ @return int The slot, starting at 0.
+ @version 0.3.0
+*/
+public func GetFiremodeSlot(firemode)
+{
+	if (GetType(firemode) == C4V_String)
+	{
+		for (var mode in GetFiremodes())
+		{
+			if (mode.name == firemode)
+			{
+				return GetCompiledFiremode(mode).slot;
+			}
+		}
+		FatalError(Format("There is no fire mode with the name %s", firemode));
+	}
+	return GetCompiledFiremode(firemode).slot;
+}
+
+/**
+ Gets the amount of shots that were fired in a fire mode.
+ @par firemode A proplist containing the fire mode information, or the name of a fire mode.
+ @return int The amount of shots.
+ @version 0.3.0
+*/
+public func GetShotCounter(firemode)
+{
+	return shot_counter[GetFiremodeSlot(firemode)] ?? 0;
+}
+
 /**
  Gets the index of a fire mode.
 
@@ -1667,26 +3076,69 @@ public func GetFiremodes()
 
 /**
  Gets all available fire modes. Available fire modes are only those where the configured condition is met.@br
- @return An array of all available fire modes.
- @version 0.2.0
+ The result is cached, and the conditions are checked again only after {@link Library_Firearm#InvalidateAvailableFiremodes},
+ or after a setter of one of the fire modes of the weapon was called. The weapon does this when fire modes are added or cleared,
+ when it is collected or dropped, and when its ammunition, or the ammunition of its ammo container, changes.
+ If a condition depends on anything else, call {@link Library_Firearm#InvalidateAvailableFiremodes} when that changes.@br
+ @return An array of all available fire modes. Do not modify the array.
+ @version 0.3.0
 */
 public func GetAvailableFiremodes()
 {
-	var available = [];
-
-	for (var i = 0; i < GetLength(GetFiremodes()); ++i) // firemode in GetFiremodes())
+	var version = GetFiremodesVersion();
+	if (available_firemodes == nil || available_firemodes.version != version)
 	{
-		var firemode = GetFiremode(i);
+		var available = [];
 
-		var is_available = IsFiremodeAvailable(firemode);
+		for (var i = 0; i < GetLength(GetFiremodes()); ++i) // firemode in GetFiremodes())
+		{
+			var firemode = GetFiremode(i);
+
+			var is_available = IsFiremodeAvailable(firemode);
+
+			if (is_available)
+			{
+				PushBack(available, firemode);
+			}
+		}
+
+		available_firemodes = {
+			modes = available,
+			version = version, // int - fire mode setters change this, see GetFiremodesVersion
+		};
+	}
 
-		if (is_available)
+	return available_firemodes.modes;
+}
+
+/**
+ Gets the latest version of the fire modes of the weapon, see {@link Library_Firearm_Firemode#GetVersion}.
+ Versions only increase, so this changes whenever a setter is called on one of the fire modes.
+ @return int The version.
+ @version 0.3.0
+*/
+func GetFiremodesVersion()
+{
+	var version = 0;
+	for (var firemode in fire_modes)
+	{
+		if (firemode)
 		{
-			PushBack(available, firemode);
+			version = Max(version, firemode->GetVersion());
 		}
 	}
+	return version;
+}
 
-	return available;
+/**
+ Discards the cached available fire modes, so that the conditions of the fire modes are checked again
+ the next time {@link Library_Firearm#GetAvailableFiremodes} is called.@br
+ Call this if something that a fire mode condition depends on changes.
+ @version 0.3.0
+*/
+public func InvalidateAvailableFiremodes()
+{
+	available_firemodes = nil;
 }
 
 func IsFiremodeAvailable(proplist firemode) // TODO: Temporary function => firemode should be base on a proplist prototype that has a function IsAvailable()
@@ -1708,6 +3160,7 @@ func IsFiremodeAvailable(proplist firemode) // TODO: Temporary function => firem
 public func ClearFiremodes()
 {
 	fire_modes = [];
+	InvalidateAvailableFiremodes();
 }
 
 /**
@@ -1717,24 +3170,30 @@ public func ClearFiremodes()
 */
 public func AddFiremode(proplist firemode)
 {
+	ValidateFiremode(firemode);
 	PushBack(fire_modes, firemode);
+	InvalidateAvailableFiremodes();
 }
 
 /**
- Checks whether the weapon is currently recovering, charging, reloading or locked.@br
+ Checks whether the weapon is currently firing a burst, recovering, charging, reloading or locked.@br
  @return {@c true} if change if fire modes is possible.
  @version 0.2.0
 */
 public func CanChangeFiremode()
 {
-	return !IsRecovering()
+	return !IsFiringBurst()
+	    && !IsRecovering()
 	    && !IsCharging()
 	    && !IsReloading()
 	    && !IsWeaponLocked();
 }
 
 /**
- Changes the firemode at the next possible time.
+ Changes the firemode at the next possible time.@br
+ If the fire mode cannot be changed right now, the change is attached to the weapon cycle:
+ it happens at the transition that makes it possible, for example when reloading or recovering is finished,
+ or when the weapon lock expires. Nothing is checked while waiting.
  
  @par number the desired fire mode index.
  @version 0.3.0
@@ -1743,12 +3202,14 @@ public func ScheduleSetFiremode(int number)
 {
 	if (this->~CanChangeFiremode())
 	{
+		ResetScheduledFiremode();
 		SetFiremode(number);
 	}
 	else
 	{
-		var schedule = GetEffect("IntChangeFiremodeEffect", this) ?? CreateEffect(IntChangeFiremodeEffect, 1, 1);
-		schedule.mode = number;
+		var cycle = GetWeaponCycle();
+		cycle.scheduled_firemode = number;
+		ScheduleWeaponCycle();
 	}
 }
 
@@ -1760,11 +3221,11 @@ public func ScheduleSetFiremode(int number)
  */
 public func GetScheduledFiremode()
 {
-	var schedule = GetEffect("IntChangeFiremodeEffect", this);
+	var cycle = GetEffect("IntWeaponCycle", this);
 
-	if (schedule)
+	if (cycle)
 	{
-		return schedule.mode;
+		return cycle.scheduled_firemode;
 	}
 	return nil;
 }
@@ -1776,29 +3237,29 @@ public func GetScheduledFiremode()
  */
 public func ResetScheduledFiremode()
 {
-	var schedule = GetEffect("IntChangeFiremodeEffect", this);
-	if (schedule)
+	var cycle = GetEffect("IntWeaponCycle", this);
+	if (cycle && cycle.scheduled_firemode != nil)
 	{
-		schedule.mode = nil;
+		cycle.scheduled_firemode = nil;
+		ScheduleWeaponCycle();
 	}
 }
 
-local IntChangeFiremodeEffect = new Effect
+/**
+ Changes to the scheduled fire mode, if the weapon state allows it.
+ Called by {@link Library_Firearm#ScheduleWeaponCycle} on every transition of the weapon state.
+ @version 0.3.0
+ */
+func ApplyScheduledFiremode()
 {
-	Timer = func()
+	var cycle = GetWeaponCycle();
+	var number = cycle.scheduled_firemode;
+	if (number != nil && this->~CanChangeFiremode())
 	{
-		// Stop if there is no mode
-		if (this.mode == nil) return FX_Execute_Kill;
-
-		if (Target->~CanChangeFiremode())
-		{
-			Target->SetFiremode(this.mode);
-			return FX_Execute_Kill;
-		}
-
-		return FX_OK;
+		cycle.scheduled_firemode = nil;
+		SetFiremode(number);
 	}
-};
+}
 
 /*-- Ammo --*/
 
@@ -1834,7 +3295,7 @@ public func HasAmmo(proplist firemode)
 	if (!Setting_WithAmmoLogic())
 		return true;
 
-	return _inherited(firemode);
+	return _inherited(GetCompiledFiremode(firemode));
 }
 
 /**
@@ -1850,19 +3311,79 @@ public func OnNoAmmo(object user, proplist firemode)
 }
 
 /**
- Called after {@link Library_Firearm#FireProjectiles}. Should somehow reduce ammo.@br
+ Takes the ammo for shots, before they are fired. Called by {@link Library_Firearm#FireProjectiles} and {@link Library_Firearm#FireBeam}.@br
+ Calls {@link Library_Firearm#HandleAmmoUsage}, and accepts the result of overloads from version 0.2.0 that return a {@c bool}:
+ these take the ammo for a single shot, so {@c true} pays for 1 shot.
+ @par firemode The ammo type for this firemode is checked.
+ @par shots The amount of shots that are fired at once. Default is 1.
+ @return int The amount of shots that ammo was available for.
+ @version 0.3.0
+ */
+func TakeAmmoForShots(proplist firemode, int shots)
+{
+	var paid = HandleAmmoUsage(firemode, shots);
+	if (GetType(paid) == C4V_Bool)
+	{
+		if (paid)
+		{
+			return 1;
+		}
+		return 0;
+	}
+	return paid;
+}
+
+/**
+ Called by {@link Library_Firearm#TakeAmmoForShots}, before the projectiles are created. Should somehow reduce ammo.@br
  Not implemented by default and will always return true (infinite ammo) as long as {@link Library_Firearm#Setting_WithAmmoLogic} is not implemented. Otherwise calls _inherited.@br
+ @note Since version 0.3.0 this returns the amount of shots instead of a {@c bool}, and gets the amount of shots
+       as a second parameter. Overloads that still return a {@c bool} work, but pay for a single shot only.
  @par firemode The ammo type for this firemode is checked.
- @return bool Returns {@code true} if the weapon has enough ammo for the firemode
- @version 0.2.0
+ @par shots The amount of shots that were fired at once. Default is 1.
+ @return int The amount of shots that ammo was available for. This is always {@code shots} as long as {@link Library_Firearm#Setting_WithAmmoLogic} is not implemented.
+ @version 0.3.0
  */
-func HandleAmmoUsage(proplist firemode)
+func HandleAmmoUsage(proplist firemode, int shots)
 {
 	// No ammo handling set up, infinite ammo
 	if (!Setting_WithAmmoLogic())
-		return true;
+		return Max(1, shots);
+
+	return _inherited(GetCompiledFiremode(firemode), shots);
+}
+
+/**
+ Reserves the ammo for several shots, for example for a burst, see {@link Library_Firearm_AmmoLogic#ReserveAmmoUsage}.@br
+ Without {@link Library_Firearm#Setting_WithAmmoLogic}, all shots are reserved. Otherwise calls _inherited.
+ @par firemode The ammo type for this firemode is reserved.
+ @par shots The amount of shots. Default is 1.
+ @return proplist The reservation. Its property {@c shots} is the amount of shots that ammo was reserved for.
+ @version 0.3.0
+ */
+func ReserveAmmoUsage(proplist firemode, int shots)
+{
+	// No ammo handling set up, infinite ammo
+	if (!Setting_WithAmmoLogic())
+		return { shots = Max(1, shots) };
+
+	return _inherited(GetCompiledFiremode(firemode), shots);
+}
+
+/**
+ Finishes a reservation from {@link Library_Firearm#ReserveAmmoUsage}. The ammo for shots that were not fired is given back.@br
+ Does nothing as long as {@link Library_Firearm#Setting_WithAmmoLogic} is not implemented. Otherwise calls _inherited.
+ @par firemode The ammo type for this firemode is committed.
+ @par reservation The reservation.
+ @par shots The amount of shots that were actually fired.
+ @return int The amount of shots that were accounted for.
+ @version 0.3.0
+ */
+func CommitAmmoUsage(proplist firemode, proplist reservation, int shots)
+{
+	if (!Setting_WithAmmoLogic())
+		return BoundBy(shots, 0, reservation.shots);
 
-	return _inherited(firemode);
+	return _inherited(GetCompiledFiremode(firemode), reservation, shots);
 }
 
 /*-- Locking --*/
@@ -1874,11 +3395,20 @@ func HandleAmmoUsage(proplist firemode)
  */
 public func LockWeapon(int lock_time)
 {
-	var effect = IsWeaponLocked();
-	if (effect == nil)
-		AddEffect("IntWeaponLocked", this, 1, lock_time, this, nil);
-	else
-		effect.Interval = lock_time;
+	var lock = { start = FrameCounter() };
+	if (lock_time)
+	{
+		lock.until = lock.start + lock_time; // int, frame - the lock ends at this frame
+	}
+	// The lock needs no timer, it simply expires
+	var cycle = GetWeaponCycle();
+	cycle.lock = lock;
+
+	// A scheduled fire mode change has to wait for the lock now
+	if (cycle.scheduled_firemode != nil)
+	{
+		ScheduleWeaponCycle();
+	}
 }
 
 /**
@@ -1887,18 +3417,25 @@ public func LockWeapon(int lock_time)
  */
 public func UnlockWeapon()
 {
-	var effect = IsWeaponLocked();
-	if (effect) RemoveEffect(nil, this, effect);
+	var cycle = GetWeaponCycle();
+	cycle.lock = nil;
+	ScheduleWeaponCycle();
 }
 
 /**
  Checks if the weapon is currently locked against usage.@br
- @return The weapon locking effect.
- @version 0.2.0
+ @return A proplist with the frame where the lock started, {@c start}, and the frame where it ends, {@c until}.
+         {@c until} is {@c nil} if the weapon stays locked until it is unlocked.
+ @version 0.3.0
 */
 func IsWeaponLocked()
 {
-	return GetEffect("IntWeaponLocked", this);
+	var lock = GetWeaponCycle().lock;
+	if (lock && lock.until != nil && FrameCounter() >= lock.until)
+	{
+		return nil;
+	}
+	return lock;
 }
 
 /*-- Misc --*/
@@ -1936,6 +3473,147 @@ public func GetAnimationSet()
 	};
 }
 
+/**
+ The properties of a fire mode that can be ranges, see {@link Library_Firearm#SampleValue}.
+ These are sampled in advance when the fire mode is compiled.
+ @return array The property names.
+ @version 0.3.0
+ */
+public func GetSampledFiremodeProperties()
+{
+	return ["projectile_speed", "projectile_range"];
+}
+
+/**
+ The amount of samples that are taken in advance for a property that is a range.
+ The samples are used in a cycle, so this should not be too small.
+ @return int The size of each sample table. Overload this for a custom size.
+ @version 0.3.0
+ */
+public func GetSampleTableSize()
+{
+	return 64;
+}
+
+/**
+ Sets the seed for the sample tables of the fire modes.@br
+ With a seed, the sample tables are filled by a deterministic generator, and each table is read from the start.
+ The same seed replays the same sequence of samples, which is useful for benchmarks and tests.
+ The tables of all fire modes are filled again the next time they are used.
+ @par seed The seed, or {@c nil} to use the engine random values.
+ @version 0.3.0
+ */
+public func SetSampleSeed(int seed)
+{
+	sample_seed = seed;
+
+	// Compile everything again, so that the tables are refilled
+	for (var compiled in compiled_firemodes ?? [])
+	{
+		compiled.version = nil;
+	}
+}
+
+/**
+ Fills the sample tables of a compiled fire mode.
+ @par compiled The compiled fire mode, see {@link Library_Firearm#GetCompiledFiremode}.
+ @version 0.3.0
+ */
+func CreateSampleTables(proplist compiled)
+{
+	var size = Max(1, this->GetSampleTableSize());
+	var properties = this->GetSampledFiremodeProperties();
+	compiled.sample_tables = {};
+	compiled.sample_cursors = {}; // each property has its own cursor, so that every table is read completely
+
+	for (var i = 0; i < GetLength(properties); ++i)
+	{
+		var property = properties[i];
+		var value = compiled[property];
+		if (GetType(value) != C4V_Array)
+		{
+			continue;
+		}
+
+		var min = value[0];
+		var step = Max(value[2], 1);
+		var count = (value[1] - min) / step;
+		var table = CreateArray(size);
+
+		// Each table gets its own sequence
+		var state = nil;
+		if (sample_seed != nil)
+		{
+			state = 1 + Abs(sample_seed + 7919 * compiled.slot + 104729 * i) % 2147483646;
+		}
+
+		for (var index = 0; index < size; ++index)
+		{
+			var roll;
+			if (state == nil)
+			{
+				roll = Random(count);
+			}
+			else
+			{
+				state = NextSampleState(state);
+				roll = state % Max(1, count);
+			}
+			table[index] = min + step * roll;
+		}
+		compiled.sample_tables[property] = table;
+
+		if (sample_seed == nil)
+		{
+			compiled.sample_cursors[property] = Random(size);
+		}
+		else
+		{
+			compiled.sample_cursors[property] = 0;
+		}
+	}
+}
+
+/**
+ Advances the deterministic generator for the sample tables.
+ This is the Park-Miller generator, computed with Schrage's method so that it does not overflow.
+ @par state The current state, between 1 and 2147483646.
+ @return int The next state, between 1 and 2147483646.
+ @version 0.3.0
+ */
+func NextSampleState(int state)
+{
+	var hi = state / 127773;
+	var lo = state % 127773;
+	state = 16807 * lo - 2836 * hi;
+	if (state <= 0)
+	{
+		state += 2147483647;
+	}
+	return state;
+}
+
+/**
+ Gets a sample of a fire mode property. If the property is a range, the next entry
+ of its sample table is read. Otherwise the property is returned as it is.
+ @par compiled The compiled fire mode, see {@link Library_Firearm#GetCompiledFiremode}.
+ @par property The name of the property, see {@link Library_Firearm#GetSampledFiremodeProperties}.
+ @return int The sampled value.
+ @version 0.3.0
+ */
+func SampleFiremodeValue(proplist compiled, string property)
+{
+	var table = compiled.sample_tables[property];
+	if (table)
+	{
+		var cursor = compiled.sample_cursors[property];
+		compiled.sample_cursors[property] = (cursor + 1) % GetLength(table);
+		var sample = table[cursor];
+		return sample;
+	}
+	return compiled[property];
+}
+
 /**
  Gets a sample of a random value.
  
@@ -11,6 +11,7 @@ static const PROJECTILE_Range_Infinite = 0;
 
 static const PROJECTILE_Deviation_Value = 0;
 static const PROJECTILE_Deviation_Precision = 1;
+static const PROJECTILE_Launch_Precision = 100; // int - minimal precision of the launch angle; deviations with this precision are used without scaling
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -108,9 +109,9 @@ public func IsHitscan()
  */
 public func Shooter(object shooter)
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
-	if (shooter == nil)
+	if (g_shooter_checked && shooter == nil)
 	{
 		FatalError(Format("Parameter 'shooter' expects an object, got nil"));
 	}
@@ -139,19 +140,19 @@ public func GetShooter()
  */
 public func Weapon(value)
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
-	if (GetType(value) == C4V_Def)
-	{
-		weapon_ID = value;
-	}
-	else if (GetType(value) == C4V_C4Object)
+	if (GetType(value) == C4V_C4Object)
 	{
 		weapon_ID = value->GetID();
 	}
 	else
 	{
-		FatalError(Format("Expected either an object or an ID, got %v: %v", GetType(value), value));
+		if (g_shooter_checked && GetType(value) != C4V_Def)
+		{
+			FatalError(Format("Expected either an object or an ID, got %v: %v", GetType(value), value));
+		}
+		weapon_ID = value;
 	}
 
 	return this;
@@ -177,16 +178,19 @@ public func GetWeaponID()
  */
 public func Range(int value)
 {
-	ProhibitedWhileLaunched();
-	
-	if (value < 0)
-	{
-		FatalError(Format("Cannot set negative range - the function received %d", value));
-	}
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
-	if (GetLifetime() > 0)
+	if (g_shooter_checked)
 	{
-		FatalError(Format("Cannot set range, because a lifetime of %d was specified already", GetLifetime()));
+		if (value < 0)
+		{
+			FatalError(Format("Cannot set negative range - the function received %d", value));
+		}
+		
+		if (GetLifetime() > 0)
+		{
+			FatalError(Format("Cannot set range, because a lifetime of %d was specified already", GetLifetime()));
+		}
 	}
 	
 	range = value;
@@ -213,16 +217,19 @@ public func GetRange()
  */
 public func Lifetime(int value)
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
-	if (value <= 0)
+	if (g_shooter_checked)
 	{
-		FatalError(Format("Must sef positive lifetime - the function received %d", value));
-	}
-	
-	if (GetRange() > 0)
-	{
-		FatalError(Format("Cannot set lifetime, because a range of %d was specified already", GetRange()));
+		if (value <= 0)
+		{
+			FatalError(Format("Must sef positive lifetime - the function received %d", value));
+		}
+		
+		if (GetRange() > 0)
+		{
+			FatalError(Format("Cannot set lifetime, because a range of %d was specified already", GetRange()));
+		}
 	}
 
 	lifetime = value;
@@ -249,7 +256,7 @@ public func GetLifetime()
  */
 public func DamageAmount(int value)
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
 	// may receive negative damage! healing projectiles :D
 	
@@ -277,7 +284,7 @@ public func GetDamageAmount()
  */
 public func DamageType(int value)
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
 	damage_type = value;
 	return this;
@@ -302,9 +309,9 @@ public func GetDamageType()
  */
 public func Velocity(int value)
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 		
-	if (value < 0)
+	if (g_shooter_checked && value < 0)
 	{
 		FatalError(Format("Cannot set negative velocity - the function received %d", value));
 	}
@@ -322,7 +329,7 @@ public func Velocity(int value)
  */
 public func HitScan()
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
 	instant = true;
 	return this;
@@ -338,9 +345,9 @@ public func HitScan()
  */
 public func Trail(int width, int length, string gfx, int speed)
 {
-	ProhibitedWhileLaunched();
+	if (g_shooter_checked) ProhibitedWhileLaunched();
 	
-	if (width < 0 || length < 0)
+	if (g_shooter_checked && (width < 0 || length < 0))
 	{
 		FatalError(Format("The trail dimensions must be positive. Got: %d/%d", width, length));
 	}
@@ -434,7 +441,7 @@ func ShouldRemoveOnHit()
 	return this.remove_on_hit;
 }
 
-public func Launch(int angle, proplist deviation)
+public func Launch(int angle, proplist deviation, int index)
 {
 	lifetime = lifetime ?? (PROJECTILE_Default_Velocity_Precision * GetRange() / Max(velocity, 1));
 
@@ -443,14 +450,14 @@ public func Launch(int angle, proplist deviation)
 
 	SetController(user->GetController());
 	
-	var precision = 100;
+	var precision = PROJECTILE_Launch_Precision;
 	
-	// get correct precision
+	// get correct precision; the deviation is shared, so it is never modified
 	if (deviation == nil)
 	{
 		// everything ok
 	}
-	else if (deviation.precision > precision)
+	else if (deviation.precision >= precision)
 	{
 		precision = deviation.precision;
 	}
@@ -460,7 +467,7 @@ public func Launch(int angle, proplist deviation)
 	}
 	
 	// get angle and velocity
-	angle = GetLaunchAngle(angle, precision, deviation);
+	angle = GetLaunchAngle(angle, precision, deviation, index);
 	velocity_x = +Sin(angle, velocity, precision);
 	velocity_y = -Cos(angle, velocity, precision);
 
@@ -1292,22 +1299,13 @@ private func ProhibitedWhileLaunched()
 }
 
 
-private func GetLaunchAngle(int angle, int precision, deviation)
+private func GetLaunchAngle(int angle, int precision, deviation, int index)
 {
 	var launch_angle = angle * precision;
 	// handle correct deviation
 	if (GetType(deviation) == C4V_PropList)
 	{
-		if (GetType(deviation.angle) == C4V_Int)
-		{
-			deviation.angle = [deviation.angle];
-		}
-
-		for (var i = 0; i < GetLength(deviation.angle); ++i)
-		{
-			var rnd = deviation.angle[i];
-			launch_angle += RandomX(-rnd, +rnd);
-		}
+		launch_angle += DrawDeviation(deviation, index);
 	}
 	else if (GetType(deviation) != C4V_Nil)
 	{
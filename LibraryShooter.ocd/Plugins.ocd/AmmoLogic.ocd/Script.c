@@ -8,7 +8,8 @@
  @version 0.3.0
  */
 
-local ammo_rate_counter; // proplist
+local ammo_rate_counter; // array - spare shots per fire mode slot, see Library_Firearm#GetFiremodeSlot
+local ammo_state; // array - resolved ammo settings per fire mode slot, see GetAmmoState
 
 /**
  Ammo logic is set up.@br
@@ -25,11 +26,32 @@ public func Setting_WithAmmoLogic()
 */
 func Initialize()
 {
-	ammo_rate_counter = {};
+	ammo_rate_counter = [];
+	ammo_state = [];
 
 	_inherited();
 }
 
+/**
+ Make sure to call this via _inherited();
+*/
+func Entrance(object container)
+{
+	InvalidateAmmoState();
+
+	_inherited(container, ...);
+}
+
+/**
+ Make sure to call this via _inherited();
+*/
+func Departure(object container)
+{
+	InvalidateAmmoState();
+
+	_inherited(container, ...);
+}
+
 /**
  @return An object that receives all ammunition calls.
  @version 0.3.0
@@ -51,17 +73,171 @@ public func GetAmmoContainer()
  */
 public func HasAmmo(proplist firemode)
 {
+	var state = GetAmmoState(firemode);
+
 	// Has no ammo if outside of a container
-	if (this->GetFiremodeAmmoSource(firemode) == AMMO_Source_Container && !this->GetAmmoContainer())
+	if (g_shooter_checked && state.source == AMMO_Source_Container && !this->GetAmmoContainer())
 	{
 		FatalError("No ammo container is defined!");
 		return false;
 	}
 
 	// Check three separate conditions
-	return this->GetAmmo(firemode) >= firemode->GetAmmoUsage()    // 1. There is enough ammo left when checking with GetAmmo
-	    || ammo_rate_counter[firemode.name] > 0                   // 2. There can still be shots fired before another ammunition piece is needed (when ammo rate is > 1)
-	    || this->GetAmmoSource(firemode) == AMMO_Source_Infinite; // 3. This mode has infinite ammo
+	return GetStateAmmo(state) >= state.usage           // 1. There is enough ammo left when checking with GetAmmo
+	    || ammo_rate_counter[state.slot] > 0            // 2. There can still be shots fired before another ammunition piece is needed (when ammo rate is > 1)
+	    || state.source == AMMO_Source_Infinite;        // 3. This mode has infinite ammo
+}
+
+/**
+ Gets the resolved ammo settings of a fire mode.@br
+ The ammunition ID, the ammo source, the object that holds the ammunition, and the ammo rate and usage
+ are resolved once and cached, so that a shot does not have to look them up again. If the weapon holds
+ the ammunition itself, the amount of ammunition is cached, too, and kept up to date by
+ {@link Library_AmmoManager#SetAmmo}. The cache is discarded when the weapon is collected or dropped,
+ or when {@link Library_Firearm_AmmoLogic#InvalidateAmmoState} is called. A fire mode that was changed
+ is resolved again automatically.
+ @par firemode A proplist containing the fire mode information.
+ @return proplist The ammo state, do not modify it.
+ @version 0.3.0
+ */
+func GetAmmoState(proplist firemode)
+{
+	var compiled = this->GetCompiledFiremode(firemode);
+	var state = ammo_state[compiled.slot];
+	if (state && state.version == compiled.version)
+	{
+		return state;
+	}
+	if (state && state.allowance)
+	{
+		state.allowance->Release();
+	}
+
+	var type = compiled->GetAmmoID();
+	var source = this->GetFiremodeAmmoSource(compiled);
+	var container;
+	if (this->~IsAmmoManager())
+		container = this;
+	else
+		container = GetAmmoContainer();
+
+	state = {
+		slot = compiled.slot,
+		version = compiled.version,
+		type = type,
+		source = source,
+		container = container,                      // object - receives the ammo calls
+		rate = compiled->GetAmmoRate() ?? 1,
+		usage = compiled->GetAmmoUsage() ?? 1,
+	};
+
+	// The amount can be tracked only if the weapon holds the ammunition itself
+	if (container == this && (source == AMMO_Source_Local || source == AMMO_Source_Infinite))
+	{
+		state.amount = this->GetAmmo(type);         // int - the amount of ammunition, nil if it is not cached
+	}
+
+	// A shared pool gives the weapon an allowance, so that the pool is not contacted for every shot
+	if (source == AMMO_Source_Container)
+	{
+		var pool = this->GetAmmoContainer();
+		if (pool && pool->~IsAmmoPool())
+		{
+			// The allowance should stay active between two shots
+			var interval = compiled->GetRecoveryDelay();
+			if (compiled.rate)
+			{
+				interval = Max(interval, WEAPON_FramesPerMinute / compiled.rate);
+			}
+			state.allowance = pool->RequestAllowance(this, type, state.usage, interval); // proplist - see Library_AmmoPool#RequestAllowance
+		}
+	}
+
+	ammo_state[compiled.slot] = state;
+	return state;
+}
+
+/**
+ Gets the amount of ammunition for an ammo state, see {@link Library_Firearm_AmmoLogic#GetAmmoState}.
+ @par state The ammo state.
+ @return int The current amount of ammunition.
+ @version 0.3.0
+ */
+func GetStateAmmo(proplist state)
+{
+	if (state.amount != nil)
+	{
+		return state.amount;
+	}
+	if (state.allowance)
+	{
+		return state.allowance->GetAvailableAmmo();
+	}
+	return this->GetAmmo(state.type);
+}
+
+/**
+ Updates the cached amount of ammunition. Called by {@link Library_AmmoManager#SetAmmo}.
+ @par ammo_type The type of the ammunition.
+ @par amount The new amount.
+ @version 0.3.0
+ */
+public func UpdateAmmoState(id ammo_type, int amount)
+{
+	for (var state in ammo_state)
+	{
+		if (state && state.amount != nil && state.type == ammo_type)
+		{
+			state.amount = amount;
+		}
+	}
+}
+
+/**
+ Callback: the ammunition of an ammo manager that contains the weapon changed, see {@link Library_AmmoManager#NotifyAmmoChange}.@br
+ If the weapon takes its ammunition from that object, the conditions of its fire modes are checked again.
+ @par container The ammo manager.
+ @par ammo_type The type of the ammunition.
+ @version 0.3.0
+ */
+public func OnAmmoContainerChange(object container, id ammo_type)
+{
+	if (container == this->GetAmmoContainer())
+	{
+		this->InvalidateAvailableFiremodes();
+	}
+}
+
+/**
+ Discards the resolved ammo settings, see {@link Library_Firearm_AmmoLogic#GetAmmoState}.@br
+ Call this if the ammo source or the ammo container of the weapon changes.
+ @version 0.3.0
+ */
+public func InvalidateAmmoState()
+{
+	for (var state in ammo_state)
+	{
+		if (state && state.allowance)
+		{
+			state.allowance->Release();
+		}
+	}
+	ammo_state = [];
+}
+
+/**
+ Validates the ammunition settings of a fire mode, see {@link Library_Firearm#ValidateFiremode}.
+ @par firemode A proplist containing the fire mode information.
+ @version 0.3.0
+ */
+func ValidateFiremode(proplist firemode)
+{
+	if (firemode->GetAmmoID() == nil)
+	{
+		FatalError("Cannot get ammunition ID!");
+	}
+
+	_inherited(firemode, ...);
 }
 
 /**
@@ -83,12 +259,12 @@ public func GetFiremodeAmmoSource(type_or_firemode)
 	if (id == nil)
 	{
 		var firemode = this->GetFiremode();
-		if (firemode == nil)
+		if (g_shooter_checked && firemode == nil)
 			return FatalError("Cannot get firemode!");
 		else
 			id = firemode->GetAmmoID();
 	}
-	if (id == nil)
+	if (g_shooter_checked && id == nil)
 		FatalError("Cannot get ammunition ID!");
 
 	if (this->~IsAmmoManager())
@@ -126,7 +302,7 @@ public func GetAmmo(type_or_firemode)
 	{
 		type = type_or_firemode;
 	}
-	else if (GetType(type) != C4V_Nil)
+	else if (g_shooter_checked && GetType(type) != C4V_Nil)
 	{
 		FatalError("GetAmmo() accepts parameters of types C4V_PropList or C4V_Def only, received %v", GetType(type_or_firemode));
 	}
@@ -134,7 +310,7 @@ public func GetAmmo(type_or_firemode)
 	if (type == nil)
 	{
 		var firemode = this->GetFiremode();
-		if (firemode == nil)
+		if (g_shooter_checked && firemode == nil)
 		{
 			FatalError("Cannot get firemode!");
 		}
@@ -144,7 +320,7 @@ public func GetAmmo(type_or_firemode)
 		}
 	}
 	// Still nothing? Well...
-	if (type == nil)
+	if (g_shooter_checked && type == nil)
 	{
 		FatalError("Cannot get ammunition ID!");
 	}
@@ -165,65 +341,175 @@ public func GetAmmo(type_or_firemode)
 }
 
 /**
- Called after a shot has been fired. Handles the depletion of ammo.@br
- Will call {@link Library_AmmoManager#DoAmmo} if shots equivalent to the the fire modes ammo rate have been fired. Either in this object if {@link Library_AmmoManager#IsAmmoManager} or {@link Library_Firearm_AmmoLogic#GetAmmoContainer}.@br
+ Called before a shot is fired. Handles the depletion of ammo.@br
+ Will take ammo from the weapon if {@link Library_AmmoManager#IsAmmoManager}, or from {@link Library_Firearm_AmmoLogic#GetAmmoContainer},
+ if shots equivalent to the the fire modes ammo rate have been fired.
+ This is a reservation for all shots, see {@link Library_Firearm_AmmoLogic#ReserveAmmoUsage}, that is committed right away.@br
  Will call {@link Library_Firearm_AmmoLogic#OnAmmoChange}
  @par firemode The ammo type for this fire mode is checked.
+ @par shots The amount of shots that were fired at once. The ammo for all of them is taken in a single call. Default is 1.
+ @return int The amount of shots that ammo was available for. Only these shots should be fired,
+             the other shots are forgotten and do not use up ammo later.
  @version 0.3.0
 */
-func HandleAmmoUsage(proplist firemode)
+func HandleAmmoUsage(proplist firemode, int shots)
 {
-	ammo_rate_counter[firemode->GetName()]--;
+	var reservation = ReserveAmmoUsage(firemode, shots);
+	return CommitAmmoUsage(firemode, reservation, reservation.shots);
+}
 
-	// default values
-	var rate = firemode->GetAmmoRate() ?? 1;
-	var ammo_type = firemode->GetAmmoID();
-	var ammo_requested = firemode->GetAmmoUsage() ?? 1;
+/**
+ Reserves the ammo for several shots, for example for a burst.@br
+ The ammo is taken right away, in a single call, see {@link Library_AmmoManager#ReserveAmmo}.
+ When the shots were fired, call {@link Library_Firearm_AmmoLogic#CommitAmmoUsage} with the amount
+ that was actually fired: the ammo for the other shots is given back.
+ @par firemode The ammo type for this fire mode is reserved.
+ @par shots The amount of shots. Default is 1.
+ @return proplist The reservation. Its property {@c shots} is the amount of shots that ammo was reserved for, this can be 0.
+ @version 0.3.0
+*/
+func ReserveAmmoUsage(proplist firemode, int shots)
+{
+	var state = GetAmmoState(firemode);
+	var rate = Max(1, state.rate);
+	var usage = Max(1, state.usage);
+	shots = Max(1, shots);
 
-	// status
-	var ammo_changed = false;
-	var enough_ammo = true;
+	// only use actual ammo if there is no spare ammo per ammo rate
+	var spare = Max(0, ammo_rate_counter[state.slot]);
+	var refills = (Max(0, shots - spare) + rate - 1) / rate;
 
-	// ammo container
-	var container;
-	if (this->~IsAmmoManager())
-		container = this;
-	else if (GetAmmoContainer())
-		container = GetAmmoContainer();
+	var reservation;
+	if (refills <= 0)
+	{
+		reservation = { ammo = state.type, amount = 0 };
+	}
 	else
-		return FatalError("Could not get a valid ammo source!");
+	{
+		reservation = ReserveAmmoFrom(state, refills * usage, usage);
+	}
 
-	// only use actual ammo if there is no spare ammo per ammo rate
-	if (ammo_rate_counter[firemode->GetName()] <= 0)
+	reservation.slot = state.slot;   // int - the fire mode slot
+	reservation.rate = rate;         // int - shots per refill
+	reservation.usage = usage;       // int - ammo per refill
+	reservation.spare = spare;       // int - spare shots before the reservation
+	reservation.shots = Min(shots, spare + reservation.amount / usage * rate); // int - shots that ammo is reserved for
+	return reservation;
+}
+
+/**
+ Finishes a reservation, see {@link Library_Firearm_AmmoLogic#ReserveAmmoUsage}.
+ The ammo for shots that were not fired is given back, and the spare shots per ammo rate are updated.
+ @par firemode A proplist containing the fire mode information.
+ @par reservation The reservation.
+ @par shots The amount of shots that were actually fired.
+ @return int The amount of shots that were accounted for.
+ @version 0.3.0
+*/
+func CommitAmmoUsage(proplist firemode, proplist reservation, int shots)
+{
+	shots = BoundBy(shots, 0, reservation.shots);
+
+	var rate = reservation.rate;
+	var refills = (Max(0, shots - reservation.spare) + rate - 1) / rate;
+	var reserved = reservation.amount;
+	var used = refills * reservation.usage;
+
+	ammo_rate_counter[reservation.slot] = reservation.spare + refills * rate - shots;
+	CommitAmmoReservation(reservation, used);
+
+	if (reserved > 0)
 	{
-		var ammo_available = GetAmmo(ammo_type);
+		this->InvalidateAvailableFiremodes();
+		this->OnAmmoChange(reservation.ammo);
+	}
+	return shots;
+}
 
-		// cancel if not enough ammo
-		if (ammo_available < ammo_requested)
-		{
-			enough_ammo = false;
-		}
-		else
-		{
-			// undo if something went wrong
-			var ammo_received = Abs(container->DoAmmo(ammo_type, -ammo_requested));
-			if (ammo_received < ammo_requested)
-			{
-				container->DoAmmo(ammo_type, ammo_received);
-				enough_ammo = false;
-			}
-			else // everything ok: fill up the spare ammo per rate, signal that something has changed
-			{
-				ammo_changed = true;
-				ammo_rate_counter[firemode->GetName()] += rate;
-			}
-		}
+/**
+ Takes ammo for a reservation, from the allowance of an ammo pool, from an ammo manager,
+ or from a container that is not an ammo manager.
+ @par state The ammo state, see {@link Library_Firearm_AmmoLogic#GetAmmoState}.
+ @par amount The maximum amount to take.
+ @par increment Only multiples of this amount are taken.
+ @return proplist The reservation, with the properties {@c ammo} and {@c amount}, see {@link Library_AmmoManager#ReserveAmmo}.
+ @version 0.3.0
+*/
+func ReserveAmmoFrom(proplist state, int amount, int increment)
+{
+	var container = state.container;
+	if (!container)
+	{
+		FatalError("Could not get a valid ammo source!");
 	}
 
-	if (ammo_changed)
+	if (state.allowance)
+	{
+		state.allowance->Request(amount);
+		return {
+			ammo = state.type,
+			amount = state.allowance->Draw(amount, increment),
+			allowance = state.allowance, // proplist - unused ammo goes back to the allowance
+		};
+	}
+	if (container->~IsAmmoManager())
+	{
+		return container->ReserveAmmo(state.type, amount, increment);
+	}
+	return {
+		ammo = state.type,
+		amount = ConsumeAmmoFrom(container, state.type, amount, increment),
+		container = container, // object - unused ammo goes back to the container
+	};
+}
+
+/**
+ Gives back the ammo of a reservation that was not used, see {@link Library_Firearm_AmmoLogic#ReserveAmmoFrom}.
+ @par reservation The reservation.
+ @par used The amount of ammo that was used.
+ @return int The amount that was given back.
+ @version 0.3.0
+*/
+func CommitAmmoReservation(proplist reservation, int used)
+{
+	if (reservation.manager)
+	{
+		return reservation.manager->CommitReservation(reservation, used);
+	}
+
+	var unused = reservation.amount - BoundBy(used, 0, reservation.amount);
+	reservation.amount = 0;
+	if (unused <= 0)
+	{
+		return 0;
+	}
+	if (reservation.allowance)
+	{
+		return reservation.allowance->Refund(unused);
+	}
+	return reservation.container->DoAmmo(reservation.ammo, unused);
+}
+
+/**
+ Takes ammunition from a container that is not an ammo manager, see {@link Library_AmmoManager#TryConsumeAmmo}.
+ @par container The object that holds the ammunition.
+ @par ammo_type The type of the ammunition.
+ @par amount The maximum amount to take.
+ @par increment Only multiples of this amount are taken.
+ @return int The amount that was taken.
+ @version 0.3.0
+ */
+func ConsumeAmmoFrom(object container, id ammo_type, int amount, int increment)
+{
+	increment = Max(1, increment);
+	var available = container->GetAmmo(ammo_type);
+	var take = Min(amount, available);
+	take -= take % increment;
+	if (take <= 0)
 	{
-		this->OnAmmoChange(ammo_type);
+		return 0;
 	}
+	return Abs(container->DoAmmo(ammo_type, -take));
 }
 
 /**
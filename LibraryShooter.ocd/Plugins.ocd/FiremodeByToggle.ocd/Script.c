@@ -10,22 +10,16 @@ local IntToggleFiremode = new Effect
 {
 	current_index = 0,
 	next_index = 0,
-	delay = 0,
 	modes = [],
 
+	// The timer is called only once, when the delay is over
 	Timer = func (int time)
 	{
-		if (delay <= 0)
+		if (current_index != next_index)
 		{
-			if (current_index != next_index)
-			{
-				Target->ScheduleSetFiremode(next_index);
-			}
-			
-			return FX_Execute_Kill;
+			Target->ScheduleSetFiremode(next_index);
 		}
-		
-		delay -= 1;
+		return FX_Execute_Kill;
 	},
 	
 	SetIndex = func (int index)
@@ -42,7 +36,9 @@ local IntToggleFiremode = new Effect
 	
 	SetDelay = func (int delay)
 	{
-		this.delay = delay;
+		// Wake up after the delay, counted from now
+		this.Time = 0;
+		this.Interval = Max(1, delay);
 	},
 
 	NextIndex = func ()
@@ -38,31 +38,51 @@ public func OnFinishReload(object user, int x, int y, proplist firemode)
 		
 		var ammo_requested = ammo_max - ammo_available; // receive only as much as you need
 
-// TODO: remove the log output once unit testing is complete
-//		Log("Reloaded: ");
-//		Log(" * ammo in source before = %d", source->GetAmmo(ammo_type));
-//		Log(" * ammo_type = %d", ammo_type);
-//		Log(" * ammo_max = %d", ammo_max);
-//		Log(" * ammo_available = %d", ammo_available);
-//		Log(" * ammo_requested = %d", ammo_requested);
-
-		var ammo_received = Abs(source->DoAmmo(ammo_type, -ammo_requested)); // see how much you can get
-//		Log(" * ammo_received = %d", ammo_received);
-		var ammo_spare = (ammo_available + ammo_received) % (firemode.ammo_usage ?? 1); // get ammo only in increments of ammo_usage
-
-		source->DoAmmo(ammo_type, ammo_spare); // give back the unecessary ammo
-		ammo_received -= ammo_spare;           // adjust the counter accordingly
-//		Log(" * ammo_spare = %d", ammo_spare);
-//		Log(" * ammo_inserted = %d", ammo_received);
-//		Log(" * ammo in source after = %d", source->GetAmmo(ammo_type));
-	
-		this->DoAmmo(ammo_type, ammo_received);
+		// get ammo only in increments of ammo_usage
+		Library_AmmoManager->TransferAmmo(source, this, ammo_type, ammo_requested, firemode.ammo_usage ?? 1);
 	}
 	
 	if (firemode.progress_bar) firemode.progress_bar->Close();
 }
 
 
+/**
+ Callback: the weapon loaded a step of an incremental reload.
+ Takes the ammo for the rounds of this step from the source container
+ and feeds it to the weapon.
+
+ @see {@link Plugin_Weapon_ReloadFromAmmoSource#GetAmmoReloadContainer}
+ @par firemode A proplist containing the fire mode information.
+ @par rounds The amount of rounds that were loaded.
+ */
+public func OnReloadStep(object user, int x, int y, proplist firemode, int rounds)
+{
+	_inherited(user, x, y, firemode, rounds, ...);
+
+	var source = this->GetAmmoReloadContainer();
+	if (source)
+	{
+		var ammo_type = firemode.ammo_id;
+		var ammo_usage = firemode.ammo_usage ?? 1;
+		var ammo_requested = Min(rounds * ammo_usage, (firemode.ammo_load ?? 1) - this->GetAmmo(ammo_type));
+
+		Library_AmmoManager->TransferAmmo(source, this, ammo_type, ammo_requested, ammo_usage);
+	}
+}
+
+/**
+ Condition when an incremental reload is complete: the weapon is
+ loaded with as much ammo as the firemode allows.
+
+ @par user The object that is using the weapon.
+ @par firemode A proplist containing the fire mode information.
+ @return {@c true} if the weapon is fully loaded.
+ */
+public func IsReloadComplete(object user, proplist firemode)
+{
+	return this->GetAmmo(firemode.ammo_id) >= (firemode.ammo_load ?? 1);
+}
+
 /**
  Condition when the weapon can be reloaded: 
  The {@link Plugin_Weapon_ReloadFromAmmoSource#GetAmmoReloadContainer}
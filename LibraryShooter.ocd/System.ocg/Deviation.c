@@ -1,10 +1,23 @@
 /**
- Handles the deviation of projectiles.
+ Handles the deviation of projectiles.@br
+ A deviation has a distribution, which decides how the deviation is drawn, see {@link Global#DrawDeviation}.
+ Each distribution needs exactly one random number per projectile.@br
+ Deviations are treated as immutable values: the functions in this file never modify
+ a deviation that is passed to them, so that one deviation can be shared by all projectiles of a fire mode.
 
  @author Marky
- @version 0.2.0
+ @version 0.3.0
  */
 
+static const DEVIATION_Uniform = 0;    // every value between -angle and +angle is equally likely; an array of angles is the sum of such values
+static const DEVIATION_Triangular = 1; // values near 0 are more likely, the likelihood decreases linearly up to -angle and +angle
+static const DEVIATION_Gaussian = 2;   // approximately normal distributed values, truncated at -angle and +angle, which is 3 standard deviations
+static const DEVIATION_Pattern = 3;    // the angle is an array of fixed values, the projectiles of a shot use one value each
+
+static const DEVIATION_Draw_Limit = 1073741823; // int - draws with a larger amount of possible outcomes are approximated
+
+static g_deviation_quantiles; // array - quantiles of the normal distribution, in 1/1000 standard deviations
+
 
 /**
  Creates a proplist that contains the information for
@@ -12,17 +25,23 @@
 
  @par angle The angle, in degrees.
  @par precision The precision factor, default precision is 1.
- @version 0.2.0
+ @par distribution The distribution, default is {@c DEVIATION_Uniform}.
+                   See the constants in this file.
+ @version 0.3.0
  */
-global func Projectile_Deviation(angle, int precision)
+global func Projectile_Deviation(angle, int precision, int distribution)
 {
 	if (GetType(angle) != C4V_Int
 	 && GetType(angle) != C4V_Array)
 	{
 		FatalError(Format("This function accepts arguments of type C4V_Int or C4V_Array for the parameter 'angle'. You passed %v", GetType(angle)));
 	}
+	if (distribution == DEVIATION_Pattern && GetType(angle) != C4V_Array)
+	{
+		FatalError(Format("A deviation pattern needs an array of angles. You passed %v", angle));
+	}
 
-	return {angle = angle, precision = precision ?? 1};
+	return {angle = angle, precision = precision ?? 1, distribution = distribution};
 }
  
 
@@ -31,34 +50,49 @@ global func Projectile_Deviation(angle, int precision)
  normalizes it so that all deviations use the same
  precision.
  
- @par deviations The deviation definitions.
+ @par deviations The deviation definitions. {@c nil} entries are ignored,
+                  the array itself is not modified.
  @par min_precision The minimal precision.
- @version 0.2.0
+ @return proplist A new deviation. Its angle is an array with one entry per angle of the deviations.
+ @version 0.3.0
  */ 
 global func NormalizeDeviations(array deviations, int min_precision)
 {
 	var precision_max = min_precision ?? 1;
-	var precisions = [];
-	RemoveHoles(deviations);
+	var count = 0;
 	for (var deviation in deviations)
 	{
-		PushBack(precisions, deviation.precision);
+		if (deviation == nil) continue;
+
 		if (deviation.precision > precision_max) precision_max = deviation.precision;
+		if (GetType(deviation.angle) == C4V_Array)
+		{
+			count += GetLength(deviation.angle);
+		}
+		else
+		{
+			count += 1;
+		}
 	}
 	
-	var angles = [];
+	var angles = CreateArray(count);
+	var index = 0;
 	for (var deviation in deviations)
 	{
+		if (deviation == nil) continue;
+
 		if (GetType(deviation.angle) == C4V_Array)
 		{
 			for (var angle in deviation.angle)
 			{
-				PushBack(angles, angle * precision_max / deviation.precision);
+				angles[index] = angle * precision_max / deviation.precision;
+				index += 1;
 			}
 		}
 		else
 		{
-			PushBack(angles, deviation.angle * precision_max / deviation.precision);
+			angles[index] = deviation.angle * precision_max / deviation.precision;
+			index += 1;
 		}
 	}
 	
@@ -68,17 +102,24 @@ global func NormalizeDeviations(array deviations, int min_precision)
 /**
  Takes a projectile deviation and scales it to fit the target precision.
  
- @par deviations The deviation definitions.
+ @par deviation The deviation definition.
  @par target_precision The target precision;
- @version 0.2.0
+ @return proplist The deviation with the target precision. This is the deviation itself,
+         if it has the target precision already, otherwise a new deviation.
+ @version 0.3.0
  */ 
 global func ScaleDeviation(proplist deviation, int target_precision)
 {
 	var factor = target_precision ?? 1;
+	if (deviation.precision == factor)
+	{
+		return deviation;
+	}
+
 	var angles;
 	if (GetType(deviation.angle) == C4V_Array)
 	{
-		angles = [];
+		angles = CreateArray(GetLength(deviation.angle));
 		for (var i = 0; i < GetLength(deviation.angle); ++i)
 		{
 			angles[i] = factor * deviation.angle[i] / deviation.precision;
@@ -89,5 +130,321 @@ global func ScaleDeviation(proplist deviation, int target_precision)
 		angles = factor * deviation.angle / deviation.precision;
 	}
 
-	return Projectile_Deviation(angles, target_precision);
+	return Projectile_Deviation(angles, target_precision, deviation.distribution);
+}
+
+
+/**
+ Merges projectile deviations into a single deviation, so that
+ the combined deviation can be drawn with one random number.@br
+ This is meant to be done once, when a fire mode is compiled,
+ see {@link Library_Firearm#GetCompiledFiremode}.@br
+ - A pattern is kept, and the other deviations are merged into its property {@c spread},
+   which is added to the pattern, see {@link Global#DrawDeviation}.@br
+ - A single deviation is kept as it is, with the common precision, unless it is a uniform deviation with too many possible outcomes.@br
+ - Uniform deviations are added up exactly.@br
+ - Everything else, or uniform deviations with too many possible
+   outcomes, is approximated by a Gaussian deviation with the same variance.
+
+ @par deviations The deviation definitions. {@c nil} entries and deviations without angle are ignored.
+ @par min_precision The minimal precision.
+ @return proplist The merged deviation, or {@c nil} if there is no deviation.
+ @version 0.3.0
+ */
+global func CompileDeviation(array deviations, int min_precision)
+{
+	var precision = min_precision ?? 1;
+	var pattern = nil;
+	var components = [];
+	for (var deviation in deviations)
+	{
+		if (deviation && deviation.angle)
+		{
+			precision = Max(precision, deviation.precision);
+			if (pattern == nil && deviation.distribution == DEVIATION_Pattern)
+			{
+				pattern = deviation;
+			}
+			else
+			{
+				PushBack(components, deviation);
+			}
+		}
+	}
+
+	var spread = MergeDeviations(components, precision);
+	if (pattern == nil)
+	{
+		return spread;
+	}
+
+	pattern = ScaleDeviation(pattern, precision);
+	if (spread == nil)
+	{
+		return pattern;
+	}
+	var combined = Projectile_Deviation(pattern.angle, precision, DEVIATION_Pattern);
+	combined.spread = spread; // proplist - random deviation that is added to the pattern
+	return combined;
+}
+
+
+/**
+ Merges projectile deviations into a single random deviation, see {@link Global#CompileDeviation}.
+
+ @par components The deviation definitions.
+ @par precision The common precision, at least the precision of each deviation.
+ @return proplist The merged deviation, or {@c nil} if there is no deviation.
+ @version 0.3.0
+ */
+global func MergeDeviations(array components, int precision)
+{
+	if (GetLength(components) == 0)
+	{
+		return nil;
+	}
+	if (GetLength(components) == 1)
+	{
+		var single = ScaleDeviation(components[0], precision);
+		if (single.distribution != DEVIATION_Uniform
+		 || GetType(single.angle) != C4V_Array
+		 || CanDrawUniformDeviation(single.angle))
+		{
+			return single;
+		}
+	}
+
+	var uniform = true;
+	var angles = [];
+	var width = 0;
+	var variance = 0;
+	for (var deviation in components)
+	{
+		var scaled = ScaleDeviation(deviation, precision);
+		variance += GetDeviationVariance(scaled);
+
+		if (GetType(scaled.angle) == C4V_Array)
+		{
+			for (var angle in scaled.angle)
+			{
+				if (scaled.distribution == DEVIATION_Pattern)
+				{
+					width = Max(width, Abs(angle));
+				}
+				else
+				{
+					width += Abs(angle);
+					PushBack(angles, Abs(angle));
+				}
+			}
+		}
+		else
+		{
+			width += Abs(scaled.angle);
+			PushBack(angles, Abs(scaled.angle));
+		}
+
+		if (scaled.distribution != DEVIATION_Uniform)
+		{
+			uniform = false;
+		}
+	}
+
+	if (uniform && CanDrawUniformDeviation(angles))
+	{
+		return Projectile_Deviation(angles, precision, DEVIATION_Uniform);
+	}
+	return Projectile_Deviation(Min(width, 3 * Sqrt(variance)), precision, DEVIATION_Gaussian);
+}
+
+
+/**
+ Checks whether a sum of uniform deviations can be drawn exactly with one random number,
+ see {@link Global#DrawDeviation}.
+
+ @par angles The angles of the uniform deviations.
+ @return bool {@c true} if the amount of possible outcomes does not exceed {@c DEVIATION_Draw_Limit}.
+ @version 0.3.0
+ */
+global func CanDrawUniformDeviation(array angles)
+{
+	var outcomes = 1;
+	for (var angle in angles)
+	{
+		var base = 2 * Abs(angle) + 1;
+		if (outcomes > DEVIATION_Draw_Limit / base)
+		{
+			return false;
+		}
+		outcomes *= base;
+	}
+	return true;
+}
+
+
+/**
+ Gets the variance of a projectile deviation.
+
+ @par deviation The deviation.
+ @return int The variance, in the square of the precision of the deviation.
+ @version 0.3.0
+ */
+global func GetDeviationVariance(proplist deviation)
+{
+	var angles = deviation.angle;
+	if (GetType(angles) != C4V_Array)
+	{
+		angles = [angles];
+	}
+
+	var variance = 0;
+	for (var angle in angles)
+	{
+		if (deviation.distribution == DEVIATION_Triangular)
+		{
+			variance += angle * angle / 6;
+		}
+		else if (deviation.distribution == DEVIATION_Gaussian)
+		{
+			variance += angle * angle / 9;
+		}
+		else if (deviation.distribution == DEVIATION_Pattern)
+		{
+			variance += angle * angle / GetLength(angles);
+		}
+		else
+		{
+			variance += angle * angle / 3;
+		}
+	}
+	return variance;
+}
+
+
+/**
+ Draws a value from a projectile deviation. This needs exactly one random number,
+ or none for a pattern without spread.
+
+ @par deviation The deviation.
+ @par index The index of the projectile in the shot. A pattern uses the angle at this index,
+            plus a value drawn from its {@c spread}, if it has one.
+            If {@c nil}, a random angle of the pattern is used, which needs another random number.
+ @return int The drawn value, in the precision of the deviation.
+ @version 0.3.0
+ */
+global func DrawDeviation(proplist deviation, int index)
+{
+	if (deviation == nil)
+	{
+		return 0;
+	}
+
+	var angle = deviation.angle;
+	var distribution = deviation.distribution;
+	if (distribution == DEVIATION_Pattern)
+	{
+		if (index == nil)
+		{
+			index = Random(GetLength(angle));
+		}
+		return angle[index % GetLength(angle)] + DrawDeviation(deviation.spread);
+	}
+	if (distribution == DEVIATION_Triangular)
+	{
+		return DrawTriangularDeviation(Abs(angle));
+	}
+	if (distribution == DEVIATION_Gaussian)
+	{
+		return DrawGaussianDeviation(Abs(angle));
+	}
+	if (GetType(angle) == C4V_Array)
+	{
+		// Sum of uniform values: one random number, split into one digit per angle
+		var outcomes = 1;
+		for (var width in angle)
+		{
+			outcomes *= 2 * Abs(width) + 1;
+		}
+		var roll = Random(outcomes);
+		var value = 0;
+		for (var width in angle)
+		{
+			var base = 2 * Abs(width) + 1;
+			value += roll % base - Abs(width);
+			roll /= base;
+		}
+		return value;
+	}
+	return RandomX(-angle, +angle);
+}
+
+
+/**
+ Draws a value between -width and +width, where the likelihood of
+ a value decreases linearly with its distance from 0.
+
+ @par width The maximum value.
+ @return int The drawn value.
+ @version 0.3.0
+ */
+global func DrawTriangularDeviation(int width)
+{
+	// Value x has the weight (width + 1 - |x|), the weights add up to (width + 1)^2.
+	// Row k of the roll has 2k + 1 entries: k + 1 of them for -(width - k), k for +(width + 1 - k)
+	var roll = Random((width + 1) * (width + 1));
+	var row = Sqrt(roll);
+	while (row * row > roll)
+	{
+		row -= 1;
+	}
+	while ((row + 1) * (row + 1) <= roll)
+	{
+		row += 1;
+	}
+	var column = roll - row * row;
+	if (column <= row)
+	{
+		return row - width;
+	}
+	return width + 1 - row;
+}
+
+
+/**
+ Draws an approximately normal distributed value from a lookup table of quantiles.
+ The values are truncated at 3 standard deviations.
+
+ @par width The maximum value, this is 3 standard deviations.
+ @return int The drawn value.
+ @version 0.3.0
+ */
+global func DrawGaussianDeviation(int width)
+{
+	var quantiles = GetDeviationQuantiles();
+	var steps = 1024;
+	var roll = Random((GetLength(quantiles) - 1) * steps);
+	var index = roll / steps;
+	var lower = quantiles[index];
+	var value = lower + (quantiles[index + 1] - lower) * (roll % steps) / steps;
+	return value * width / 3000;
+}
+
+
+/**
+ Gets the lookup table for {@link Global#DrawGaussianDeviation}.
+
+ @return array The quantiles of the normal distribution at 0, 1/64, ..., 64/64, in 1/1000
+         standard deviations. The outer values are truncated at 3 standard deviations.
+ @version 0.3.0
+ */
+global func GetDeviationQuantiles()
+{
+	if (g_deviation_quantiles == nil)
+	{
+		g_deviation_quantiles = [-3000, -2154, -1863, -1676, -1534, -1418, -1318, -1230, -1150, -1078, -1010, -947, -887, -831, -776, -725,
+		                         -674, -626, -579, -533, -489, -445, -402, -360, -319, -278, -237, -197, -157, -118, -78, -39,
+		                         0, 39, 78, 118, 157, 197, 237, 278, 319, 360, 402, 445, 489, 533, 579,
+		                         626, 674, 725, 776, 831, 887, 947, 1010, 1078, 1150, 1230, 1318, 1418, 1534, 1676, 1863, 2154, 3000];
+	}
+	return g_deviation_quantiles;
 }
@@ -0,0 +1,63 @@
+/**
+ Limits the amount of sounds that are started in an area, so that rapid
+ fire does not create more sound instances than can usefully be mixed.
+
+ @author Marky
+ @version 0.3.0
+ */
+
+static const SOUND_Voice_Duration = 10;   // int, frames - a started sound occupies a voice for this long
+static const SOUND_Voice_Radius = 200;    // int, pixels - sounds within this distance share their voices
+static const SOUND_Voice_AreaLimit = 8;   // int - maximum amount of voices in an area
+
+static g_sound_voices; // array - the sounds that were started recently
+
+
+/**
+ Plays a sound in the calling object, unless the voice limit of the area is exceeded.@br
+ The sound is not played if:@br
+ - the same sound was started in the same area in this frame already, the sounds are merged.@br
+ - {@c SOUND_Voice_AreaLimit} sounds were started in the area during the last {@c SOUND_Voice_Duration} frames.@br
+ 
+ @par name The name of the sound, see Sound().
+ @par volume The volume, see Sound().
+ @par pitch The pitch, see Sound().
+ @return bool {@c true} if the sound was played.
+ @version 0.3.0
+ */
+global func ThrottledSound(string name, int volume, int pitch)
+{
+	AssertObjectContext("ThrottledSound()");
+
+	var frame = FrameCounter();
+	var x = GetX();
+	var y = GetY();
+	var voices = 0;
+
+	g_sound_voices = g_sound_voices ?? [];
+
+	for (var i = GetLength(g_sound_voices) - 1; i >= 0; --i)
+	{
+		var voice = g_sound_voices[i];
+
+		// Forget voices that ended
+		if (frame - voice.frame >= SOUND_Voice_Duration)
+		{
+			RemoveArrayIndex(g_sound_voices, i, true);
+			continue;
+		}
+
+		if (Distance(x, y, voice.x, voice.y) > SOUND_Voice_Radius) continue;
+
+		// Merge with the same sound in the same frame
+		if (voice.frame == frame && voice.name == name) return false;
+
+		voices += 1;
+	}
+
+	if (voices >= SOUND_Voice_AreaLimit) return false;
+
+	PushBack(g_sound_voices, {name = name, x = x, y = y, frame = frame});
+	Sound(name, false, volume, nil, nil, nil, pitch);
+	return true;
+}
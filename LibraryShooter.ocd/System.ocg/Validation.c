@@ -0,0 +1,36 @@
+/**
+ Validation profile of the library.@br
+ By default the library runs unchecked: fire modes are validated once,
+ when they are added, selected or compiled, see {@link Library_Firearm#ValidateFiremode},
+ and the functions that run on every shot skip their argument checks.@br
+ A scenario that is used for debugging can enable the checked profile
+ with {@link Global#SetShooterChecked} in its Initialize() function.
+ Then every call validates its arguments again.
+
+ @author Marky
+ @version 0.3.0
+ */
+
+static g_shooter_checked; // bool - if true, the arguments are validated on every call
+
+
+/**
+ Enables or disables the checked validation profile.
+ @par checked If {@c true}, all arguments are validated on every call.
+ @version 0.3.0
+ */
+global func SetShooterChecked(bool checked)
+{
+	g_shooter_checked = checked;
+}
+
+
+/**
+ Checks whether the checked validation profile is enabled.
+ @return bool {@c true} if all arguments are validated on every call.
+ @version 0.3.0
+ */
+global func IsShooterChecked()
+{
+	return g_shooter_checked;
+}
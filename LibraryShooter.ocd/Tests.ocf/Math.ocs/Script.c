@@ -256,6 +256,150 @@ global func Test3_Completed()
 
 global func Test3_OnFinished(){}
 
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test4_OnStart()
+{
+	Log("Test for math function, projectile deviations: NormalizeDeviations does not modify its arguments");
+	return true;
+}
+
+global func Test4_Completed()
+{
+	var deviations = [Projectile_Deviation(1, 1), nil, Projectile_Deviation([2, 3], 10)];
+
+	var deviation_normalized = NormalizeDeviations(deviations, 100);
+	
+	var passed = doTest("Normalizing deviations uses the minimal precision. Got %d, expected %d.", deviation_normalized.precision, 100);
+	passed &= doTest("Normalizing deviations skips nil and scales the angles correctly. Got %v, expected %v.", deviation_normalized.angle, [100, 20, 30]);
+	passed &= doTest("Normalizing deviations keeps the array. Got length %d, expected %d.", GetLength(deviations), 3);
+	passed &= doTest("Normalizing deviations keeps the angles. Got %v, expected %v.", deviations[2].angle, [2, 3]);
+
+	if (!passed) FailTest();
+	return true;
+}
+
+global func Test4_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test5_OnStart()
+{
+	Log("Test for math function, projectile deviations: shared deviations give the same results");
+	return true;
+}
+
+global func Test5_Completed()
+{
+	var deviation = Projectile_Deviation([1, 2], 10);
+	var deviation_scaled = ScaleDeviation(deviation, 100);
+
+	var passed = doTest("Scaling a deviation scales the angles correctly. Got %v, expected %v.", deviation_scaled.angle, [10, 20]);
+	passed &= doTest("Scaling a deviation uses the target precision. Got %d, expected %d.", deviation_scaled.precision, 100);
+	passed &= doTest("Scaling a deviation keeps the original angles. Got %v, expected %v.", deviation.angle, [1, 2]);
+	passed &= doTest("Scaling a deviation to its own precision returns the deviation. Got %v, expected %v.", ScaleDeviation(deviation, 10) == deviation, true);
+
+	var deviations = [Projectile_Deviation(1, 1), Projectile_Deviation(2, 10)];
+	var deviation_compiled = CompileDeviation(deviations, 100);
+	var deviation_normalized = NormalizeDeviations(deviations, 100);
+	passed &= doTest("Compiling uniform deviations gives the normalized angles. Got %v, expected %v.", deviation_compiled.angle, deviation_normalized.angle);
+	passed &= doTest("Compiling uniform deviations gives the normalized precision. Got %d, expected %d.", deviation_compiled.precision, deviation_normalized.precision);
+
+	// Drawing from a shared deviation must not modify it
+	var deviation_shared = Projectile_Deviation(5, 100);
+	var min_value = 0, max_value = 0;
+	var in_range = true;
+	for (var i = 0; i < 1000; ++i)
+	{
+		var value = DrawDeviation(deviation_shared);
+		min_value = Min(min_value, value);
+		max_value = Max(max_value, value);
+
+		var sum = DrawDeviation(deviation_compiled);
+		in_range &= Abs(sum) <= 120;
+	}
+	passed &= doTest("Drawing a deviation keeps the angle. Got %v, expected %v.", GetType(deviation_shared.angle), C4V_Int);
+	passed &= doTest("Min drawn value is %d, expected %d.", min_value, -5);
+	passed &= doTest("Max drawn value is %d, expected %d.", max_value, 5);
+	passed &= doTest("Drawing merged deviations stays within their sum. Got %v, expected %v.", in_range, true);
+
+	if (!passed) FailTest();
+	return true;
+}
+
+global func Test5_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test6_OnStart()
+{
+	Log("Test for math function, projectile deviations: distributions");
+	return true;
+}
+
+global func Test6_Completed()
+{
+	var triangular = Projectile_Deviation(3, 100, DEVIATION_Triangular);
+	var gaussian = Projectile_Deviation(30, 100, DEVIATION_Gaussian);
+	var triangular_min = 0, triangular_max = 0;
+	var gaussian_min = 0, gaussian_max = 0;
+	for (var i = 0; i < 1000; ++i)
+	{
+		var value = DrawDeviation(triangular);
+		triangular_min = Min(triangular_min, value);
+		triangular_max = Max(triangular_max, value);
+
+		value = DrawDeviation(gaussian);
+		gaussian_min = Min(gaussian_min, value);
+		gaussian_max = Max(gaussian_max, value);
+	}
+
+	var passed = doTest("Min triangular value is %d, expected %d.", triangular_min, -3);
+	passed &= doTest("Max triangular value is %d, expected %d.", triangular_max, 3);
+	passed &= doTest("Gaussian values stay within the angle. Got %v, expected %v.", gaussian_min >= -30 && gaussian_max <= 30, true);
+	passed &= doTest("Gaussian values spread to both sides. Got %v, expected %v.", gaussian_min < 0 && gaussian_max > 0, true);
+
+	var pattern = Projectile_Deviation([-10, 0, 10], 1, DEVIATION_Pattern);
+	var drawn = [];
+	for (var index = 0; index < 6; ++index)
+	{
+		PushBack(drawn, DrawDeviation(pattern, index));
+	}
+	passed &= doTest("A pattern uses the angle at the projectile index. Got %v, expected %v.", drawn, [-10, 0, 10, -10, 0, 10]);
+
+	// The default spread of a fire mode must not replace the pattern
+	var compiled = CompileDeviation([Projectile_Deviation(1, 100), pattern], 100);
+	passed &= doTest("Compiling a pattern keeps the pattern. Got %v, expected %v.", compiled.distribution, DEVIATION_Pattern);
+	passed &= doTest("Compiling a pattern scales the angles correctly. Got %v, expected %v.", compiled.angle, [-1000, 0, 1000]);
+	passed &= doTest("Compiling a pattern keeps the other deviations as spread. Got %v, expected %v.", compiled.spread.angle, 1);
+	var in_range = true;
+	for (var i = 0; i < 100; ++i)
+	{
+		in_range &= Inside(DrawDeviation(compiled, 2), 999, 1001);
+	}
+	passed &= doTest("Drawing a pattern with spread stays around the pattern angle. Got %v, expected %v.", in_range, true);
+
+	// A single deviation with too many possible outcomes is approximated, too
+	var wide = CompileDeviation([nil, Projectile_Deviation([20, 20, 20], 1)], 100);
+	passed &= doTest("A single wide deviation is approximated. Got %v, expected %v.", wide.distribution, DEVIATION_Gaussian);
+	in_range = true;
+	for (var i = 0; i < 100; ++i)
+	{
+		in_range &= Inside(DrawDeviation(wide), -6000, 6000);
+	}
+	passed &= doTest("Drawing the approximated deviation stays within the angles. Got %v, expected %v.", in_range, true);
+	var narrow = CompileDeviation([nil, Projectile_Deviation([2, 2, 2], 1)], 100);
+	passed &= doTest("A single narrow deviation is kept. Got %v, expected %v.", narrow.angle, [200, 200, 200]);
+
+	if (!passed) FailTest();
+	return true;
+}
+
+global func Test6_OnFinished(){}
+
 
 /**
  Gets the exponent of a value.
@@ -0,0 +1,12 @@
+#include Library_AmmoManager
+
+// An ammo depot for the tests, it holds arrows as items and everything else as numbers.
+
+public func GetAmmoSource(id ammo)
+{
+	if (ammo == Arrow)
+	{
+		return AMMO_Source_Items;
+	}
+	return AMMO_Source_Local;
+}
@@ -0,0 +1,4 @@
+#include AmmoDepot
+#include Library_AmmoPool
+
+// An ammo depot for the tests that shares its ammunition with weapons as a pool.
@@ -0,0 +1,43 @@
+#include Library_AmmoManager
+#include Plugin_Firearm_AmmoLogic
+#include Weapon
+#include Plugin_Firearm_ReloadFromAmmoSource
+
+// The test weapon, with ammo logic. The tests decide where the ammunition comes from.
+
+local ammo_source;    // int - the ammo source for all ammunition, AMMO_Source_Local by default
+local ammo_container; // object - the object that holds the ammunition for AMMO_Source_Container, and the reserves for reloading
+
+public func SetAmmoSupply(int source, object container)
+{
+	ammo_source = source;
+	ammo_container = container;
+	InvalidateAmmoState();
+}
+
+public func GetAmmoSource(id ammo)
+{
+	return ammo_source ?? AMMO_Source_Local;
+}
+
+public func GetAmmoContainer()
+{
+	return ammo_container;
+}
+
+public func GetAmmoReloadContainer()
+{
+	return ammo_container;
+}
+
+// Reload when the magazine is not full, if the fire mode has a magazine
+public func NeedsReload(object user, proplist firemode)
+{
+	return firemode.ammo_load != nil && this->GetAmmo(firemode) < firemode.ammo_load;
+}
+
+// Fire while the use button is held, so that the tests can pull the trigger with DoFireCycle()
+public func Setting_AimOnUseStart()
+{
+	return false;
+}
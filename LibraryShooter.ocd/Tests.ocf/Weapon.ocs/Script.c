@@ -161,6 +161,15 @@ global func askUser(string message)
 
 /*-- The actual tests --*/
 
+global func CreateTestWeapon(id type)
+{
+	if (Test().weapon) Test().weapon->RemoveObject();
+
+	Test().weapon = Test().user->CreateContents(type ?? Weapon);
+
+	return Test().weapon;
+}
+
 // --------------------------------------------------------------------------------------------------------
 // --------------------------------------------------------------------------------------------------------
 
@@ -178,19 +187,1190 @@ global func Test1_Completed()
 	                 [1000, 1000]]; // 135�
 	                 
 	                 
+	var passed = true;
+
 	for (var coordinates in test_data)
 	{
 		var aim_angle = Test().weapon->GetAngle(coordinates[0], coordinates[1]);
 		var fire_angle = Test().weapon->GetFireAngle(coordinates[0], coordinates[1], Test().weapon->GetFiremode());
 		
 		var expected_aim_angle = Angle(0, 0, coordinates[0], coordinates[1]);
-		var expected_fire_angle = Angle(0, -5, coordinates[0], coordinates[1]);
+		var expected_fire_angle = Angle(0, Test().weapon->GetFiremode().projectile_offset_y, coordinates[0], coordinates[1]);
 		
-		doTest("Aiming angle is %d, should be %d", aim_angle, expected_aim_angle);
-		doTest("Firing angle is %d, should be %d", fire_angle, expected_fire_angle);
+		passed &= doTest("Aiming angle is %d, should be %d", aim_angle, expected_aim_angle);
+		passed &= doTest("Firing angle is %d, should be %d", fire_angle, expected_fire_angle);
 	}
 
-	return false;
+	return passed || FailTest();
 }
 
 global func Test1_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test2_OnStart()
+{
+	Log("Test for Weapon: The weapon cycle sleeps until the next process is due");
+
+	var weapon = CreateTestWeapon();
+	weapon->GetFiremode()->SetRecoveryDelay(10);
+	weapon->Fire(Test().user, 1000, 0);
+
+	Test().recovery_end = FrameCounter() + 10;
+
+	var passed = true;
+	passed &= doTest("The weapon state after a shot is %d, expected %d.", weapon->GetWeaponState(), WEAPON_State_Recovering);
+	passed &= doTest("The weapon cycle wakes up after %d frames, expected %d.", weapon->GetWeaponCycle().Interval, 10);
+	Test().passed = passed;
+	return true;
+}
+
+global func Test2_Completed()
+{
+	var weapon = Test().weapon;
+
+	// Wait for the recovery
+	if (FrameCounter() < Test().recovery_end)
+	{
+		if (weapon->GetWeaponState() == WEAPON_State_Recovering)
+		{
+			return false;
+		}
+		fail(Format("The weapon stopped recovering at frame %d, before frame %d", FrameCounter(), Test().recovery_end));
+		return FailTest();
+	}
+	// In the last frame, the result depends on the order of the effects
+	if (FrameCounter() == Test().recovery_end)
+	{
+		return false;
+	}
+
+	var passed = Test().passed;
+	passed &= doTest("The weapon state after recovering is %d, expected %d.", weapon->GetWeaponState(), WEAPON_State_Idle);
+	passed &= doTest("The idle weapon cycle has the interval %d, expected %d.", weapon->GetWeaponCycle().Interval, 0);
+
+	weapon->LockWeapon(5);
+	passed &= doTest("The weapon state after locking is %d, expected %d.", weapon->GetWeaponState(), WEAPON_State_Locked);
+	passed &= doTest("The locked weapon cycle has the interval %d, expected %d.", weapon->GetWeaponCycle().Interval, 0);
+
+	weapon->UnlockWeapon();
+	passed &= doTest("The weapon state after unlocking is %d, expected %d.", weapon->GetWeaponState(), WEAPON_State_Idle);
+
+	return passed || FailTest();
+}
+
+global func Test2_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test3_OnStart()
+{
+	Log("Test for Weapon: Charge progress is reported at the progress thresholds");
+
+	var weapon = CreateTestWeapon();
+	weapon->GetFiremode()->SetChargeDelay(20);
+	weapon.GetProgressGranularity = Global.Test3_ProgressGranularity;
+	weapon.OnProgressCharge = Global.Test3_OnProgressCharge;
+
+	Test().progress = [];
+	Test().charge_end = FrameCounter() + 20;
+
+	weapon->DoFireCycle(Test().user, 1000, 0, true);
+
+	return doTest("The weapon state after pulling the trigger is %d, expected %d.", weapon->GetWeaponState(), WEAPON_State_Charging);
+}
+
+global func Test3_Completed()
+{
+	if (FrameCounter() <= Test().charge_end)
+	{
+		return false;
+	}
+
+	var passed = true;
+	var expected = [25, 50, 75, 100];
+
+	passed &= doTest("The progress was reported %d times, expected %d.", GetLength(Test().progress), GetLength(expected));
+	for (var i = 0; i < GetLength(expected); ++i)
+	{
+		passed &= doTest("The progress was reported at %d percent, expected %d.", Test().progress[i], expected[i]);
+	}
+	passed &= doTest("The charged weapon cycle has the interval %d, expected %d.", Test().weapon->GetWeaponCycle().Interval, 0);
+
+	return passed || FailTest();
+}
+
+global func Test3_OnFinished(){}
+
+global func Test3_ProgressGranularity(proplist firemode)
+{
+	return 25;
+}
+
+global func Test3_OnProgressCharge(object user, int x, int y, proplist firemode, int current_percent, int change_percent)
+{
+	PushBack(Test().progress, current_percent);
+}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test4_OnStart()
+{
+	Log("Test for Weapon: Shots that are due in the same frame are fired together, as long as there is ammo");
+
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->GetFiremode()->SetMode(WEAPON_FM_Auto)->SetFireRate(7200); // 3 1/3 shots per frame
+	weapon->SetAmmo(Dummy, 16);
+
+	Test().shots = [];
+	return true;
+}
+
+global func Test4_Completed()
+{
+	var weapon = Test().weapon;
+
+	// Hold the trigger, the test control pulls it every 2 frames
+	weapon->DoFireCycle(Test().user, 1000, 0, true);
+	PushBack(Test().shots, weapon->GetShotCounter(weapon->GetFiremode()));
+
+	// The first shot is due immediately, then 6 2/3 shots every 2 frames, until the ammo runs out
+	var expected = [1, 7, 14, 16, 16];
+	if (GetLength(Test().shots) < GetLength(expected))
+	{
+		return false;
+	}
+
+	var passed = true;
+	for (var i = 0; i < GetLength(expected); ++i)
+	{
+		passed &= doTest("The weapon fired %d shots in total, expected %d.", Test().shots[i], expected[i]);
+	}
+	passed &= doTest("The weapon has %d ammo left, expected %d.", weapon->GetAmmo(Dummy), 0);
+	passed &= doTest("The weapon has %d spare shots, expected %d.", weapon.ammo_rate_counter[weapon->GetFiremodeSlot(weapon->GetFiremode())], 0);
+
+	return passed || FailTest();
+}
+
+global func Test4_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test5_OnStart()
+{
+	Log("Test for Weapon: A cancelled burst gives back the ammo for the rounds that were not fired");
+
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->GetFiremode()->SetMode(WEAPON_FM_Burst)->SetBurstAmount(5)->SetRecoveryDelay(4);
+	weapon->SetAmmo(Dummy, 10);
+
+	weapon->Fire(Test().user, 1000, 0);
+
+	var passed = true;
+	passed &= doTest("The weapon fires a burst: %v, expected %v.", weapon->IsFiringBurst() != nil, true);
+	passed &= doTest("The ammo for the burst is reserved, %d ammo left, expected %d.", weapon->GetAmmo(Dummy), 5);
+	passed &= doTest("The first round was fired, %d shots in total, expected %d.", weapon->GetShotCounter(weapon->GetFiremode()), 1);
+	Test().passed = passed;
+	return true;
+}
+
+global func Test5_Completed()
+{
+	var weapon = Test().weapon;
+	var burst = weapon->IsFiringBurst();
+
+	// Cancel the burst after the second round
+	if (burst && burst.fired < 2)
+	{
+		return false;
+	}
+
+	var passed = Test().passed;
+	passed &= doTest("The burst is still being fired: %v, expected %v.", burst != nil, true);
+	if (!burst)
+	{
+		return FailTest();
+	}
+
+	var fired = burst.fired;
+	weapon->CancelBurst();
+
+	passed &= doTest("The burst was cancelled: %v, expected %v.", weapon->IsFiringBurst() == nil, true);
+	passed &= doTest("The weapon fired %d shots in total, expected %d.", weapon->GetShotCounter(weapon->GetFiremode()), fired);
+	passed &= doTest("The weapon has %d ammo left, expected %d.", weapon->GetAmmo(Dummy), 10 - fired);
+	passed &= doTest("The weapon has %d spare shots, expected %d.", weapon.ammo_rate_counter[weapon->GetFiremodeSlot(weapon->GetFiremode())], 0);
+
+	return passed || FailTest();
+}
+
+global func Test5_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test6_OnStart()
+{
+	Log("Test for Weapon: Compiled fire modes are rebuilt only when the fire mode changes");
+	return true;
+}
+
+global func Test6_Completed()
+{
+	var weapon = CreateTestWeapon();
+	var firemode = weapon->GetFiremode();
+	var derived = { Prototype = firemode, name = "Derived" };
+
+	var passed = true;
+
+	var compiled = weapon->GetCompiledFiremode(firemode);
+	var slot = compiled.slot;
+	var version = compiled.version;
+	passed &= doTest("The copy has the damage %d, expected %d.", compiled.damage, firemode.damage);
+	passed &= doTest("The copy has the projectile speed %d, expected %d.", compiled.projectile_speed, firemode.projectile_speed);
+	passed &= doTest("The copy is cached: %v, expected %v.", weapon->GetCompiledFiremode(firemode) == compiled, true);
+	passed &= doTest("A copy is not compiled again: %v, expected %v.", weapon->GetCompiledFiremode(compiled) == compiled, true);
+
+	var derived_compiled = weapon->GetCompiledFiremode(derived);
+	passed &= doTest("The derived fire mode has the damage %d, expected %d.", derived_compiled.damage, firemode.damage);
+
+	firemode->SetDamage(25);
+
+	compiled = weapon->GetCompiledFiremode(firemode);
+	passed &= doTest("The copy was compiled again with the damage %d, expected %d.", compiled.damage, 25);
+	passed &= doTest("The version of the copy increased: %v, expected %v.", compiled.version > version, true);
+	passed &= doTest("The slot of the copy is %d, expected %d.", compiled.slot, slot);
+
+	derived_compiled = weapon->GetCompiledFiremode(derived);
+	passed &= doTest("The derived fire mode was compiled again with the damage %d, expected %d.", derived_compiled.damage, 25);
+	passed &= doTest("The derived fire mode has its own slot: %v, expected %v.", derived_compiled.slot != slot, true);
+
+	return passed || FailTest();
+}
+
+global func Test6_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test7_OnStart()
+{
+	Log("Test for Weapon: Shots are counted per fire mode slot");
+	return true;
+}
+
+global func Test7_Completed()
+{
+	var weapon = CreateTestWeapon();
+	var first = weapon->GetFiremode(0);
+	var second = { Prototype = first, name = "Second" };
+	weapon->AddFiremode(second);
+
+	var passed = true;
+
+	var first_slot = weapon->GetFiremodeSlot(first);
+	var second_slot = weapon->GetFiremodeSlot(second);
+	passed &= doTest("The fire modes have different slots: %v, expected %v.", first_slot != second_slot, true);
+	passed &= doTest("The slot of the fire mode by name is %d, expected %d.", weapon->GetFiremodeSlot("Second"), second_slot);
+
+	weapon->Fire(Test().user, 1000, 0);
+	weapon->Fire(Test().user, 1000, 0);
+	weapon->SetFiremode(1, true);
+	weapon->Fire(Test().user, 1000, 0);
+
+	passed &= doTest("The first fire mode fired %d shots, expected %d.", weapon->GetShotCounter(first), 2);
+	passed &= doTest("The second fire mode fired %d shots, expected %d.", weapon->GetShotCounter(second), 1);
+	passed &= doTest("The second fire mode by name fired %d shots, expected %d.", weapon->GetShotCounter("Second"), 1);
+
+	second->SetDamage(5);
+	passed &= doTest("The slot of a changed fire mode is %d, expected %d.", weapon->GetFiremodeSlot(second), second_slot);
+	passed &= doTest("The changed fire mode keeps its counter, %d shots, expected %d.", weapon->GetShotCounter(second), 1);
+
+	return passed || FailTest();
+}
+
+global func Test7_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test8_OnStart()
+{
+	Log("Test for Weapon: Available fire modes are cached until something invalidates them");
+	return true;
+}
+
+global func Test8_Completed()
+{
+	var weapon = CreateTestWeapon();
+	var first = weapon->GetFiremode(0);
+	var second = { Prototype = first, name = "Conditional", condition = "Test8_Condition" };
+	weapon.Test8_Condition = Global.Test8_Condition;
+
+	Test().condition_met = false;
+	Test().condition_checks = 0;
+	weapon->AddFiremode(second);
+
+	var passed = true;
+
+	passed &= doTest("There are %d available fire modes, expected %d.", GetLength(weapon->GetAvailableFiremodes()), 1);
+	passed &= doTest("The condition was checked %d times, expected %d.", Test().condition_checks, 1);
+
+	Test().condition_met = true;
+	passed &= doTest("The cached fire modes are %d, expected %d.", GetLength(weapon->GetAvailableFiremodes()), 1);
+	passed &= doTest("The condition was checked %d times, expected %d.", Test().condition_checks, 1);
+
+	weapon->InvalidateAvailableFiremodes();
+	passed &= doTest("After invalidating, there are %d available fire modes, expected %d.", GetLength(weapon->GetAvailableFiremodes()), 2);
+	passed &= doTest("The condition was checked %d times, expected %d.", Test().condition_checks, 2);
+
+	Test().condition_met = false;
+	first->SetDamage(5);
+	passed &= doTest("After changing a fire mode, there are %d available fire modes, expected %d.", GetLength(weapon->GetAvailableFiremodes()), 1);
+	passed &= doTest("The condition was checked %d times, expected %d.", Test().condition_checks, 3);
+
+	// The fire modes of other weapons do not matter
+	Test().condition_met = true;
+	var other = CreateObject(Weapon, 0, 0, NO_OWNER);
+	other->GetFiremode()->SetDamage(5);
+	other->RemoveObject();
+	passed &= doTest("After changing the fire mode of another weapon, the cached fire modes are %d, expected %d.", GetLength(weapon->GetAvailableFiremodes()), 1);
+	passed &= doTest("The condition was checked %d times, expected %d.", Test().condition_checks, 3);
+
+	// The ammunition in the ammo container of the weapon changes
+	var depot = CreateAmmoDepot();
+	weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->Enter(depot);
+	weapon->SetAmmoSupply(AMMO_Source_Container, depot);
+	weapon->AddFiremode({ Prototype = weapon->GetFiremode(0), name = "Loaded", condition = "Test8_AmmoCondition" });
+	weapon.Test8_AmmoCondition = Global.Test8_AmmoCondition;
+
+	passed &= doTest("Without ammo in the container, there are %d available fire modes, expected %d.", GetLength(weapon->GetAvailableFiremodes()), 1);
+	depot->SetAmmo(Dummy, 5);
+	passed &= doTest("With ammo in the container, there are %d available fire modes, expected %d.", GetLength(weapon->GetAvailableFiremodes()), 2);
+
+	return passed || FailTest();
+}
+
+global func Test8_OnFinished(){}
+
+global func Test8_Condition()
+{
+	Test().condition_checks += 1;
+	return Test().condition_met;
+}
+
+global func Test8_AmmoCondition()
+{
+	return Test().weapon->GetAmmo(Dummy) > 0;
+}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test9_OnStart()
+{
+	Log("Test for Weapon: A scheduled fire mode change happens when the weapon state allows it");
+
+	var weapon = CreateTestWeapon();
+	var first = weapon->GetFiremode(0);
+	first->SetRecoveryDelay(10);
+	weapon->AddFiremode({ Prototype = first, name = "Second" });
+
+	weapon->Fire(Test().user, 1000, 0);
+	weapon->ScheduleSetFiremode(1);
+
+	var passed = true;
+	passed &= doTest("The fire mode did not change while recovering: %v, expected %v.", weapon->GetFiremode() == first, true);
+	passed &= doTest("The scheduled fire mode is %v, expected %v.", weapon->GetScheduledFiremode(), 1);
+	Test().passed = passed;
+	Test().phase = 1;
+	return true;
+}
+
+global func Test9_Completed()
+{
+	var weapon = Test().weapon;
+
+	if (Test().phase == 1)
+	{
+		if (weapon->IsRecovering())
+		{
+			return false;
+		}
+
+		Test().passed &= doTest("After recovering, the fire mode is %v, expected %v.", weapon->GetFiremodeIndex(weapon->GetFiremode()), 1);
+		Test().passed &= doTest("After recovering, the scheduled fire mode is %v, expected %v.", weapon->GetScheduledFiremode(), nil);
+
+		weapon->LockWeapon(6);
+		weapon->ScheduleSetFiremode(0);
+		Test().lock_end = FrameCounter() + 6;
+		Test().passed &= doTest("The weapon cycle wakes up after %d frames for the change, expected %d.", weapon->GetWeaponCycle().Interval, 6);
+		Test().phase = 2;
+		return false;
+	}
+
+	if (FrameCounter() <= Test().lock_end)
+	{
+		return false;
+	}
+
+	var passed = Test().passed;
+	passed &= doTest("After the lock, the fire mode is %v, expected %v.", weapon->GetFiremodeIndex(weapon->GetFiremode()), 0);
+	passed &= doTest("After the lock, the scheduled fire mode is %v, expected %v.", weapon->GetScheduledFiremode(), nil);
+	passed &= doTest("The expired lock was removed: %v, expected %v.", weapon->GetWeaponCycle().lock == nil, true);
+	passed &= doTest("The idle weapon cycle has the interval %d, expected %d.", weapon->GetWeaponCycle().Interval, 0);
+
+	return passed || FailTest();
+}
+
+global func Test9_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test10_OnStart()
+{
+	Log("Test for Weapon: Ranges in fire modes are sampled from pre-sampled tables");
+	return true;
+}
+
+global func Test10_Completed()
+{
+	var weapon = CreateTestWeapon();
+	var firemode = weapon->GetFiremode();
+	firemode.projectile_speed = [100, 200, 10];
+	firemode.projectile_range = [500, 600];
+	firemode->IncreaseVersion();
+
+	weapon->SetSampleSeed(42);
+	var compiled = weapon->GetCompiledFiremode(firemode);
+	var speeds = compiled.sample_tables.projectile_speed;
+	var ranges = compiled.sample_tables.projectile_range;
+	var size = weapon->GetSampleTableSize();
+
+	var passed = true;
+
+	passed &= doTest("The speed table has %d entries, expected %d.", GetLength(speeds), size);
+	passed &= doTest("The range table has %d entries, expected %d.", GetLength(ranges), size);
+
+	var valid = true;
+	for (var speed in speeds)
+	{
+		valid &= speed >= 100 && speed < 200 && speed % 10 == 0;
+	}
+	passed &= doTest("All sampled speeds are in the range, in steps of 10: %v, expected %v.", valid, true);
+
+	// Each property has its own cursor, and reads its table from the start with a seed
+	for (var i = 0; i < 3; ++i)
+	{
+		passed &= doTest("The sampled speed is %d, expected %d.", weapon->SampleFiremodeValue(compiled, "projectile_speed"), speeds[i]);
+	}
+	passed &= doTest("The sampled range is %d, expected %d.", weapon->SampleFiremodeValue(compiled, "projectile_range"), ranges[0]);
+	passed &= doTest("A property that is no range is returned as it is, %d, expected %d.", weapon->SampleFiremodeValue(compiled, "damage"), compiled.damage);
+
+	// The cursor wraps around
+	for (var i = 3; i < size; ++i)
+	{
+		weapon->SampleFiremodeValue(compiled, "projectile_speed");
+	}
+	passed &= doTest("After a full cycle, the sampled speed is %d, expected %d.", weapon->SampleFiremodeValue(compiled, "projectile_speed"), speeds[0]);
+
+	// The same seed replays the same samples
+	weapon->SetSampleSeed(42);
+	compiled = weapon->GetCompiledFiremode(firemode);
+	var replayed = true;
+	for (var i = 0; i < size; ++i)
+	{
+		replayed &= compiled.sample_tables.projectile_speed[i] == speeds[i];
+	}
+	passed &= doTest("The same seed fills the same table: %v, expected %v.", replayed, true);
+
+	return passed || FailTest();
+}
+
+global func Test10_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test11_OnStart()
+{
+	Log("Test for Weapon: The weapon works with the checked validation profile");
+	return true;
+}
+
+global func Test11_Completed()
+{
+	var weapon = CreateTestWeapon();
+	var firemode = weapon->GetFiremode();
+
+	var passed = true;
+
+	// The tests run with the default, unchecked profile
+	passed &= doTest("The checked profile is %v, expected %v.", IsShooterChecked(), false);
+
+	passed &= doTest("The selected fire mode is found: %v, expected %v.", weapon->GetFiremode() == firemode, true);
+	weapon->Fire(Test().user, 1000, 0);
+	passed &= doTest("The weapon fired %d shots, expected %d.", weapon->GetShotCounter(firemode), 1);
+
+	SetShooterChecked(true);
+	passed &= doTest("The checked profile is %v, expected %v.", IsShooterChecked(), true);
+
+	weapon->CancelRecovery();
+	weapon->Fire(Test().user, 1000, 0);
+	passed &= doTest("The weapon fired %d shots, expected %d.", weapon->GetShotCounter(firemode), 2);
+
+	return passed || FailTest();
+}
+
+global func Test11_OnFinished()
+{
+	SetShooterChecked(false);
+}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test12_OnStart()
+{
+	Log("Test for Weapon: The ammo state is cached until it is invalidated");
+	return true;
+}
+
+global func Test12_Completed()
+{
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	var firemode = weapon->GetFiremode();
+	weapon->SetAmmo(Dummy, 5);
+
+	var passed = true;
+
+	var state = weapon->GetAmmoState(firemode);
+	passed &= doTest("The cached amount is %d, expected %d.", state.amount, 5);
+	passed &= doTest("The state is cached: %v, expected %v.", weapon->GetAmmoState(firemode) == state, true);
+
+	weapon->DoAmmo(Dummy, 3);
+	passed &= doTest("The state is kept when the ammo changes: %v, expected %v.", weapon->GetAmmoState(firemode) == state, true);
+	passed &= doTest("The cached amount is updated to %d, expected %d.", state.amount, 8);
+	passed &= doTest("The weapon has ammo: %v, expected %v.", weapon->HasAmmo(firemode), true);
+
+	firemode->SetAmmoUsage(10);
+	var changed = weapon->GetAmmoState(firemode);
+	passed &= doTest("The state is resolved again after a fire mode change: %v, expected %v.", changed != state, true);
+	passed &= doTest("The new state has the ammo usage %d, expected %d.", changed.usage, 10);
+	passed &= doTest("The weapon has ammo: %v, expected %v.", weapon->HasAmmo(firemode), false);
+
+	weapon->InvalidateAmmoState();
+	passed &= doTest("The state is resolved again after invalidating: %v, expected %v.", weapon->GetAmmoState(firemode) != changed, true);
+
+	return passed || FailTest();
+}
+
+global func Test12_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func CreateAmmoDepot(id type)
+{
+	if (Test().depot) Test().depot->RemoveObject();
+
+	Test().depot = CreateObject(type ?? AmmoDepot, LandscapeWidth() / 2, Test().user->GetY(), NO_OWNER);
+
+	return Test().depot;
+}
+
+global func Test13_OnStart()
+{
+	Log("Test for Weapon: Ammo is consumed and reserved in a single call");
+	return true;
+}
+
+global func Test13_Completed()
+{
+	var depot = CreateAmmoDepot();
+	depot->SetAmmo(Dummy, 10);
+
+	var passed = true;
+
+	passed &= doTest("Consuming 4 ammo takes %d, expected %d.", depot->TryConsumeAmmo(Dummy, 4), 4);
+	passed &= doTest("Consuming 8 ammo takes everything or nothing, %d, expected %d.", depot->TryConsumeAmmo(Dummy, 8), 0);
+	passed &= doTest("Consuming 8 ammo in steps of 4 takes %d, expected %d.", depot->TryConsumeAmmo(Dummy, 8, 4), 4);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 2);
+
+	var reservation = depot->ReserveAmmo(Dummy, 2);
+	passed &= doTest("The reservation has %d ammo, expected %d.", reservation.amount, 2);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 0);
+	passed &= doTest("Committing 1 used ammo gives back %d, expected %d.", depot->CommitReservation(reservation, 1), 1);
+	passed &= doTest("Committing again gives back %d, expected %d.", depot->CommitReservation(reservation, 1), 0);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 1);
+
+	// A weapon that gets its ammo from the depot takes it in a single call, too
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->SetAmmoSupply(AMMO_Source_Container, depot);
+	passed &= doTest("The weapon consumes %d ammo from the depot, expected %d.", weapon->TryConsumeAmmo(Dummy, 1), 1);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 0);
+
+	// The ammo of a reserved burst goes back to the depot, except for the rounds that were fired
+	depot->SetAmmo(Dummy, 6);
+	var firemode = weapon->GetFiremode();
+	firemode->SetAmmoRate(2);
+	reservation = weapon->ReserveAmmoUsage(firemode, 5);
+	passed &= doTest("The weapon reserved %d shots, expected %d.", reservation.shots, 5);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 3);
+	passed &= doTest("The weapon accounts for %d shots, expected %d.", weapon->CommitAmmoUsage(firemode, reservation, 2), 2);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 5);
+
+	return passed || FailTest();
+}
+
+global func Test13_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test14_OnStart()
+{
+	Log("Test for Weapon: Ammo is transferred between ammo managers in a single call");
+	return true;
+}
+
+global func Test14_Completed()
+{
+	var depot = CreateAmmoDepot();
+	depot->SetAmmo(Dummy, 10);
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->SetAmmoSupply(AMMO_Source_Local, depot);
+
+	var passed = true;
+
+	passed &= doTest("Transferring 7 ammo moves %d, expected %d.", Library_AmmoManager->TransferAmmo(depot, weapon, Dummy, 7), 7);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 3);
+	passed &= doTest("The weapon has %d ammo, expected %d.", weapon->GetAmmo(Dummy), 7);
+
+	passed &= doTest("Transferring 5 ammo in steps of 2 moves %d, expected %d.", Library_AmmoManager->TransferAmmo(depot, weapon, Dummy, 5, 2), 2);
+	passed &= doTest("The depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 1);
+	passed &= doTest("The weapon has %d ammo, expected %d.", weapon->GetAmmo(Dummy), 9);
+
+	passed &= doTest("Transferring nothing moves %d, expected %d.", Library_AmmoManager->TransferAmmo(depot, weapon, Dummy, 0), 0);
+
+	// Reloading takes what is available, up to the magazine size
+	var firemode = weapon->GetFiremode();
+	firemode.ammo_load = 12;
+	weapon->OnFinishReload(Test().user, 1000, 0, firemode);
+	passed &= doTest("After reloading, the weapon has %d ammo, expected %d.", weapon->GetAmmo(Dummy), 10);
+	passed &= doTest("After reloading, the depot has %d ammo left, expected %d.", depot->GetAmmo(Dummy), 0);
+
+	return passed || FailTest();
+}
+
+global func Test14_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test15_OnStart()
+{
+	Log("Test for Weapon: Ammo from items is counted when the items enter or leave");
+	return true;
+}
+
+global func Test15_Completed()
+{
+	var depot = CreateAmmoDepot();
+	var stack_size = Arrow->MaxStackCount();
+
+	var passed = true;
+
+	var arrows = CreateObject(Arrow, 0, 0, NO_OWNER);
+	arrows->SetStackCount(4);
+	arrows->Enter(depot);
+	passed &= doTest("The depot counts %d arrows, expected %d.", depot->GetAmmo(Arrow), 4);
+
+	arrows->Exit();
+	passed &= doTest("After the arrows left, the depot counts %d arrows, expected %d.", depot->GetAmmo(Arrow), 0);
+	arrows->RemoveObject();
+
+	// More than a stack, so that several items are created
+	passed &= doTest("Adding arrows adds %d, expected %d.", depot->DoAmmo(Arrow, stack_size + 5), stack_size + 5);
+	passed &= doTest("The depot has %d arrow items, expected %d.", depot->ContentsCount(Arrow), 2);
+
+	passed &= doTest("Consuming arrows takes %d, expected %d.", depot->TryConsumeAmmo(Arrow, stack_size + 2, 1), stack_size + 2);
+	passed &= doTest("The depot counts %d arrows, expected %d.", depot->GetAmmo(Arrow), 3);
+	passed &= doTest("The depot has %d arrow items, expected %d.", depot->ContentsCount(Arrow), 1);
+	passed &= doTest("Counting the items again gives %d arrows, expected %d.", depot->UpdateAmmoItems(Arrow), 3);
+
+	var item = depot->FindContents(Arrow);
+	passed &= doTest("The remaining item has %d arrows, expected %d.", item->GetStackCount(), 3);
+
+	// Stacks that change their count are counted again
+	arrows = CreateObject(Arrow, 0, 0, NO_OWNER);
+	arrows->SetStackCount(4);
+	arrows->TryAddToStack(item);
+	passed &= doTest("After merging a stack into the item, the item has %d arrows, expected %d.", item->GetStackCount(), 7);
+	passed &= doTest("After merging a stack into the item, the depot counts %d arrows, expected %d.", depot->GetAmmo(Arrow), 7);
+	if (arrows) arrows->RemoveObject();
+
+	item->DoStackCount(-2);
+	passed &= doTest("After changing the stack count, the depot counts %d arrows, expected %d.", depot->GetAmmo(Arrow), 5);
+
+	item->RemoveObject();
+	passed &= doTest("After the item was removed, the depot counts %d arrows, expected %d.", depot->GetAmmo(Arrow), 0);
+
+	return passed || FailTest();
+}
+
+global func Test15_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test16_OnStart()
+{
+	Log("Test for Weapon: A weapon with a high ammo usage draws from a shared pool");
+
+	var depot = CreateAmmoDepot(AmmoPoolDepot);
+	depot->SetAmmo(Dummy, 40);
+
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->SetAmmoSupply(AMMO_Source_Container, depot);
+	var firemode = weapon->GetFiremode();
+	firemode->SetAmmoUsage(8);
+
+	var allowance = weapon->GetAmmoState(firemode).allowance;
+	Test().allowance = allowance;
+
+	var passed = true;
+	passed &= doTest("The weapon has an allowance: %v, expected %v.", allowance != nil, true);
+	if (!allowance)
+	{
+		Test().passed = false;
+		return true;
+	}
+	passed &= doTest("The allowance holds %d ammo, expected %d.", allowance.amount, 16);
+	passed &= doTest("The weapon has ammo: %v, expected %v.", weapon->HasAmmo(firemode), true);
+
+	// Three shots in the same frame, the third one has to wait for the settlement
+	for (var i = 0; i < 3; ++i)
+	{
+		weapon->Fire(Test().user, 1000, 0);
+	}
+	passed &= doTest("The weapon fired %d shots, expected %d.", weapon->GetShotCounter(firemode), 2);
+	passed &= doTest("The allowance holds %d ammo, expected %d.", allowance.amount, 0);
+	passed &= doTest("The pool has %d ammo, expected %d.", depot->GetAmmo(Dummy), 24);
+	passed &= doTest("The weapon has ammo: %v, expected %v.", weapon->HasAmmo(firemode), false);
+	passed &= doTest("Checking for ammo does not use the pool, it has %d ammo, expected %d.", depot->GetAmmo(Dummy), 24);
+
+	Test().passed = passed;
+	Test().refilled = 0;
+	Test().timeout = FrameCounter() + 100;
+	return true;
+}
+
+global func Test16_Completed()
+{
+	var depot = Test().depot;
+	var allowance = Test().allowance;
+	var settlement = GetEffect("IntAmmoPoolSettlement", depot);
+
+	if (!Test().passed)
+	{
+		return FailTest();
+	}
+
+	// The settlement refills the allowance, and takes the ammo back when the allowance is idle
+	Test().refilled = Max(Test().refilled, allowance.amount);
+	if (allowance.amount > 0 || (settlement && settlement.Interval > 0))
+	{
+		if (FrameCounter() < Test().timeout)
+		{
+			return false;
+		}
+		fail(Format("The allowance still holds %d ammo", allowance.amount));
+		return FailTest();
+	}
+
+	var passed = true;
+	passed &= doTest("The settlement refilled the allowance with %d ammo, expected %d.", Test().refilled, 24);
+	passed &= doTest("The pool has %d ammo, expected %d.", depot->GetAmmo(Dummy), 24);
+
+	// The idle allowance can use the pool, and is refilled when the weapon needs it
+	var weapon = Test().weapon;
+	passed &= doTest("The weapon has ammo: %v, expected %v.", weapon->HasAmmo(weapon->GetFiremode()), true);
+	passed &= doTest("The idle allowance holds %d ammo, expected %d.", allowance.amount, 0);
+	weapon->Fire(Test().user, 1000, 0);
+	passed &= doTest("The weapon fired %d shots, expected %d.", weapon->GetShotCounter(weapon->GetFiremode()), 3);
+	passed &= doTest("The allowance holds %d ammo, expected %d.", allowance.amount, 8);
+	passed &= doTest("The pool has %d ammo, expected %d.", depot->GetAmmo(Dummy), 8);
+
+	return passed || FailTest();
+}
+
+global func Test16_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test17_OnStart()
+{
+	Log("Test for Weapon: An incremental reload loads round by round and can be interrupted to fire");
+
+	var depot = CreateAmmoDepot();
+	depot->SetAmmo(Dummy, 10);
+
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->SetAmmoSupply(AMMO_Source_Local, depot);
+	var firemode = weapon->GetFiremode();
+	firemode.ammo_load = 4;
+	firemode->SetReloadStep(1)->SetReloadDelay(4)->SetRecoveryDelay(2);
+
+	weapon->StartReload(Test().user, 1000, 0, true);
+
+	Test().phase = 0;
+	Test().timeout = FrameCounter() + 100;
+	return true;
+}
+
+global func Test17_Completed()
+{
+	var weapon = Test().weapon;
+	var user = Test().user;
+	var passed = true;
+
+	if (FrameCounter() > Test().timeout)
+	{
+		fail(Format("The test did not finish, it stopped in phase %d", Test().phase));
+		return FailTest();
+	}
+
+	if (Test().phase == 0)
+	{
+		// A step takes 5 frames, so the second round is still loaded at the next poll
+		if (weapon->GetAmmo(Dummy) < 2)
+		{
+			return false;
+		}
+		passed &= doTest("The weapon is reloading: %v, expected %v.", weapon->IsReloading() != nil, true);
+
+		// Pulling the trigger interrupts reloading, and the weapon fires with what it has
+		weapon->ControlUseStart(user, 1000, 0);
+		passed &= doTest("After pulling the trigger, the weapon is reloading: %v, expected %v.", weapon->IsReloading() != nil, false);
+		passed &= doTest("After pulling the trigger, the weapon has %d ammo, expected %d.", weapon->GetAmmo(Dummy), 2);
+		passed &= doTest("The depot has %d ammo left, expected %d.", Test().depot->GetAmmo(Dummy), 8);
+
+		weapon->DoFireCycle(user, 1000, 0, true);
+		passed &= doTest("After the first shot, the weapon has %d ammo, expected %d.", weapon->GetAmmo(Dummy), 1);
+		passed &= doTest("After the first shot, the weapon is reloading: %v, expected %v.", weapon->IsReloading() != nil, false);
+	}
+	else if (Test().phase == 1)
+	{
+		if (weapon->IsRecovering())
+		{
+			return false;
+		}
+		weapon->DoFireCycle(user, 1000, 0, true);
+		passed &= doTest("After the second shot, the weapon has %d ammo, expected %d.", weapon->GetAmmo(Dummy), 0);
+	}
+	else
+	{
+		if (weapon->IsRecovering())
+		{
+			return false;
+		}
+
+		// Out of ammo, so the trigger starts reloading again
+		weapon->DoFireCycle(user, 1000, 0, true);
+		passed &= doTest("Without ammo, the weapon is reloading: %v, expected %v.", weapon->IsReloading() != nil, true);
+		passed &= doTest("The weapon fired %d shots, expected %d.", weapon->GetShotCounter(weapon->GetFiremode()), 2);
+		return passed || FailTest();
+	}
+
+	if (!passed)
+	{
+		return FailTest();
+	}
+	Test().phase += 1;
+	return false;
+}
+
+global func Test17_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test18_OnStart()
+{
+	Log("Test for Weapon: An overheated weapon is locked until the heat has decayed");
+
+	var weapon = CreateTestWeapon();
+	weapon->GetFiremode()->SetHeatPerShot(40)->SetHeatLimit(100)->SetHeatDecay(360)->SetRecoveryDelay(1);
+
+	// 120 heat, that is 4320 in 1/36 units, decays by 360 per frame: 12 frames
+	for (var i = 0; i < 3; ++i)
+	{
+		weapon->Fire(Test().user, 1000, 0);
+	}
+	Test().start = FrameCounter();
+	Test().lockout_end = Test().start + 12;
+
+	var passed = true;
+	var cooldown = weapon->IsCoolingDown();
+	passed &= doTest("The weapon has %d heat, expected %d.", weapon->GetHeat(), 120);
+	passed &= doTest("The weapon overheated: %v, expected %v.", cooldown && cooldown.overheat, true);
+	if (cooldown)
+	{
+		passed &= doTest("The lockout ends at frame %d, expected %d.", cooldown.wake, Test().lockout_end);
+	}
+	Test().passed = passed;
+	return true;
+}
+
+global func Test18_Completed()
+{
+	var weapon = Test().weapon;
+
+	if (!Test().passed)
+	{
+		return FailTest();
+	}
+
+	if (FrameCounter() < Test().lockout_end)
+	{
+		var heat = (4320 - 360 * (FrameCounter() - Test().start)) / 36;
+		Test().passed &= doTest("The weapon is cooling down: %v, expected %v.", weapon->IsCoolingDown() != nil, true);
+		Test().passed &= doTest("The weapon has %d heat, expected %d.", weapon->GetHeat(), heat);
+		return false;
+	}
+	// In the last frame, the result depends on the order of the effects
+	if (FrameCounter() == Test().lockout_end)
+	{
+		return false;
+	}
+
+	var passed = true;
+	passed &= doTest("After the lockout, the weapon is cooling down: %v, expected %v.", weapon->IsCoolingDown() != nil, false);
+	passed &= doTest("After the lockout, the weapon has %d heat, expected %d.", weapon->GetHeat(), 0);
+	passed &= doTest("After the lockout, the weapon is ready to fire: %v, expected %v.", weapon->IsReadyToFire(), true);
+
+	return passed || FailTest();
+}
+
+global func Test18_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test19_OnStart()
+{
+	Log("Test for Weapon: Without heat decay, an overheated weapon is locked for the cooldown delay");
+
+	var weapon = CreateTestWeapon();
+	weapon->GetFiremode()->SetHeatPerShot(40)->SetHeatLimit(100)->SetHeatDecay(0)->SetCooldownDelay(8)->SetRecoveryDelay(1);
+
+	for (var i = 0; i < 3; ++i)
+	{
+		weapon->Fire(Test().user, 1000, 0);
+	}
+	Test().lockout_end = FrameCounter() + 8;
+
+	var passed = true;
+	var cooldown = weapon->IsCoolingDown();
+	passed &= doTest("The weapon overheated: %v, expected %v.", cooldown && cooldown.overheat, true);
+	if (cooldown)
+	{
+		passed &= doTest("The lockout ends at frame %d, expected %d.", cooldown.wake, Test().lockout_end);
+	}
+	Test().passed = passed;
+	return true;
+}
+
+global func Test19_Completed()
+{
+	var weapon = Test().weapon;
+
+	if (!Test().passed)
+	{
+		return FailTest();
+	}
+
+	// The heat stays until the lockout ends
+	if (FrameCounter() < Test().lockout_end)
+	{
+		Test().passed &= doTest("The weapon is cooling down: %v, expected %v.", weapon->IsCoolingDown() != nil, true);
+		Test().passed &= doTest("The weapon has %d heat, expected %d.", weapon->GetHeat(), 120);
+		return false;
+	}
+	// In the last frame, the result depends on the order of the effects
+	if (FrameCounter() == Test().lockout_end)
+	{
+		return false;
+	}
+
+	var passed = true;
+	passed &= doTest("After the lockout, the weapon is cooling down: %v, expected %v.", weapon->IsCoolingDown() != nil, false);
+	passed &= doTest("After the lockout, the weapon has %d heat, expected %d.", weapon->GetHeat(), 0);
+
+	return passed || FailTest();
+}
+
+global func Test19_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test20_OnStart()
+{
+	Log("Test for Weapon: The spread blooms with every shot and decays over time");
+
+	var weapon = CreateTestWeapon();
+	weapon->GetFiremode()->SetSpread(Projectile_Deviation(4, 1))->SetSpreadLimit(20)->SetSpreadDecay(10);
+
+	weapon->Fire(Test().user, 1000, 0);
+	weapon->Fire(Test().user, 1000, 0);
+
+	Test().passed = doTest("After two shots, the spread is %d, expected %d.", weapon->GetBloom(), 8);
+
+	// The deviation for the current spread is merged only once
+	var compiled = weapon->GetCompiledFiremode(weapon->GetFiremode());
+	var deviation = weapon->GetSpread(compiled);
+	Test().passed &= doTest("The deviation is kept for the same spread: %v, expected %v.", weapon->GetSpread(compiled) == deviation, true);
+	Test().phase = 0;
+	Test().frame = FrameCounter();
+	Test().bloom = 8 * 36; // in 1/36 units, so that the decay is exact
+	return true;
+}
+
+global func Test20_Completed()
+{
+	var weapon = Test().weapon;
+
+	if (!Test().passed)
+	{
+		return FailTest();
+	}
+	if (FrameCounter() < Test().frame + 3)
+	{
+		return false;
+	}
+
+	// The spread decays by 10 per second, that is 10/36 per frame
+	var bloom = Max(0, Test().bloom - 10 * (FrameCounter() - Test().frame));
+	var passed = doTest("The spread decayed to %d, expected %d.", weapon->GetBloom(), bloom / 36);
+
+	if (Test().phase == 0)
+	{
+		// Another shot adds to what is left
+		weapon->Fire(Test().user, 1000, 0);
+		bloom += 4 * 36;
+		passed &= doTest("After another shot, the spread is %d, expected %d.", weapon->GetBloom(), bloom / 36);
+
+		Test().passed = passed;
+		Test().phase = 1;
+		Test().frame = FrameCounter();
+		Test().bloom = bloom;
+		return false;
+	}
+
+	// The spread does not grow beyond the limit
+	for (var i = 0; i < 10; ++i)
+	{
+		weapon->Fire(Test().user, 1000, 0);
+	}
+	passed &= doTest("After many shots, the spread is %d, expected %d.", weapon->GetBloom(), 20);
+
+	return passed || FailTest();
+}
+
+global func Test20_OnFinished(){}
+
+// --------------------------------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------------------------------
+
+global func Test21_OnStart()
+{
+	Log("Test for Weapon: A beam damages the first target in every tick, and stops when released or out of ammo");
+
+	var weapon = CreateTestWeapon(AmmoWeapon);
+	weapon->GetFiremode()->SetMode(WEAPON_FM_Beam)->SetRecoveryDelay(6)->SetDamage(5);
+	weapon->SetAmmo(Dummy, 3);
+
+	// A target to the left of the user, in the path of the beam
+	var user = Test().user;
+	var target = CreateObject(Clonk, user->GetX() - 60, user->GetY(), NO_OWNER);
+	target.OnWeaponDamageShooter = Global.Test21_OnWeaponDamageShooter;
+	Test().beam_target = target;
+	Test().hits = [];
+	Test().timeout = FrameCounter() + 100;
+
+	weapon->DoFireCycle(user, -1000, 100, true);
+
+	var passed = true;
+	passed &= doTest("The weapon has a beam: %v, expected %v.", weapon->GetBeam() != nil, true);
+	passed &= doTest("The beam hit %d times, expected %d.", GetLength(Test().hits), 1);
+	Test().passed = passed;
+	return true;
+}
+
+global func Test21_OnWeaponDamageShooter(object shooter, int damage, int damage_type)
+{
+	PushBack(Test().hits, [FrameCounter(), damage]);
+}
+
+global func Test21_Completed()
+{
+	var weapon = Test().weapon;
+	var user = Test().user;
+
+	if (!Test().passed)
+	{
+		return FailTest();
+	}
+
+	// Hold the trigger until the ammo runs out
+	weapon->DoFireCycle(user, -1000, 100, true);
+	if (weapon->GetBeam())
+	{
+		if (FrameCounter() < Test().timeout)
+		{
+			return false;
+		}
+		fail("The beam did not stop when the weapon ran out of ammo");
+		return FailTest();
+	}
+
+	var passed = true;
+	var hits = Test().hits;
+	var delay = weapon->GetFiremode().delay_recover;
+	passed &= doTest("The beam hit %d times, expected %d.", GetLength(hits), 3);
+	passed &= doTest("The weapon has %d ammo left, expected %d.", weapon->GetAmmo(Dummy), 0);
+	for (var i = 0; i < GetLength(hits); ++i)
+	{
+		passed &= doTest("The beam dealt %d damage, expected %d.", hits[i][1], 5);
+		if (i > 0)
+		{
+			// The test pulls the trigger every 2 frames
+			var ticks = hits[i][0] - hits[i - 1][0];
+			passed &= doTest("The tick took %v frames, expected at least the recovery delay: %v.", ticks >= delay && ticks <= delay + 2, true);
+		}
+	}
+
+	// Releasing the trigger stops the beam
+	weapon->SetAmmo(Dummy, 5);
+	weapon->DoFireCycle(user, -1000, 100, true);
+	passed &= doTest("With new ammo, the weapon has a beam: %v, expected %v.", weapon->GetBeam() != nil, true);
+	passed &= doTest("The beam hit %d times, expected %d.", GetLength(Test().hits), 4);
+	weapon->ControlUseStop(user, -1000, 100);
+	passed &= doTest("After releasing the trigger, the weapon has a beam: %v, expected %v.", weapon->GetBeam() != nil, false);
+	passed &= doTest("The weapon has %d ammo left, expected %d.", weapon->GetAmmo(Dummy), 4);
+
+	return passed || FailTest();
+}
+
+global func Test21_OnFinished()
+{
+	if (Test().beam_target) Test().beam_target->RemoveObject();
+}
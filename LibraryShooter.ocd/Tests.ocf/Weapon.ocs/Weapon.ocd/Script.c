@@ -1,5 +1,4 @@
 #include Library_Firearm
-#include Plugin_Firearm_FiremodeBySelection
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -21,8 +20,9 @@ public func GetCarryTransform()
 public func Initialize()
 {
 	_inherited(...);
-	firemode_default = new firemode_default{};
-	ChangeFiremode(firemode_default);
+	ClearFiremodes();
+	AddFiremode(new firemode_default {});
+	SetFiremode(0, true);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -57,11 +57,14 @@ local firemode_default =
 	projectile_distance = 10,
 	projectile_offset_y = -10,
 	projectile_number =    1,
-	projectile_spread = [0, 100], // default inaccuracy of a single projectile
+	projectile_spread = { angle: 0, precision: 100 }, // default inaccuracy of a single projectile
 
-	spread = [0, 100],			  // inaccuracy from prolonged firing
+	spread = { angle: 0, precision: 100 }, // inaccuracy from prolonged firing
 
 	burst = 0, // number of projectiles fired in a burst
+
+	// Getters and Setters
+	Prototype = Library_Firearm_Firemode,
 };
 
 